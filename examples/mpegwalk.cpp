@@ -0,0 +1,80 @@
+/* Copyright (C) 2026 by the TagLib developers
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the throughput of reading the audio properties of MP3 files with
+// the Accurate read style, which walks the headers of all frames of streams
+// without a VBR header.  Each file is read a number of times, so that the
+// result does not depend on the file system cache.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include "tstring.h"
+#include "mpegfile.h"
+#include "mpegproperties.h"
+
+using namespace TagLib;
+
+int main(int argc, char *argv[])
+{
+  if(argc < 2) {
+    std::cout << "Usage: mpegwalk [-n <count>] <file1> [<file2> ...]" << std::endl;
+    return 1;
+  }
+
+  int count = 10;
+  int first = 1;
+  if(argc > 3 && String(argv[1]) == "-n") {
+    count = std::max(1, std::atoi(argv[2]));
+    first = 3;
+  }
+
+  for(int i = first; i < argc; i++) {
+    long long bytes = 0;
+    int length = 0;
+    int bitrate = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for(int j = 0; j < count; j++) {
+      MPEG::File f(argv[i], true, MPEG::Properties::Accurate);
+      if(!f.isValid() || !f.audioProperties()) {
+        std::cout << argv[i] << ": not a valid MPEG file" << std::endl;
+        break;
+      }
+      bytes += f.length();
+      length = f.audioProperties()->lengthInMilliseconds();
+      bitrate = f.audioProperties()->bitrate();
+    }
+
+    const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    if(bytes == 0 || seconds.count() <= 0)
+      continue;
+
+    std::cout << argv[i] << ": " << length << " ms, " << bitrate << " kb/s, "
+              << bytes / seconds.count() / (1024 * 1024) << " MiB/s" << std::endl;
+  }
+}
@@ -39,7 +39,7 @@ while test $# -gt 0
 do
   case $1 in
     --libs)
-	  flags="$flags -L$libdir -ltag @ZLIB_LIBRARIES_FLAGS@"
+	  flags="$flags -L$libdir -ltag @ZLIB_LIBRARIES_FLAGS@ @THREADS_LIBRARIES_FLAGS@"
 	  ;;
     --cflags)
 	  flags="$flags -I$includedir -I$includedir/taglib"
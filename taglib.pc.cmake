@@ -7,5 +7,5 @@ Name: TagLib
 Description: Audio meta-data library
 Requires:
 Version: @TAGLIB_LIB_VERSION_STRING@
-Libs: -L${libdir} -ltag @ZLIB_LIBRARIES_FLAGS@
+Libs: -L${libdir} -ltag @ZLIB_LIBRARIES_FLAGS@ @THREADS_LIBRARIES_FLAGS@
 Cflags: -I${includedir} -I${includedir}/taglib
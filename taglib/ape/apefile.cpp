@@ -71,31 +71,35 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool APE::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, bufferSize(), true));
+}
+
+bool APE::File::isSupported(const ByteVector &data)
 {
   // An APE file has an ID "MAC " somewhere. An ID3v2 tag may precede.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true);
-  return (buffer.find("MAC ") >= 0);
+  return (data.find("MAC ") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-APE::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+APE::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-APE::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+APE::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 APE::File::~File() = default;
@@ -236,7 +240,7 @@ bool APE::File::hasID3v1Tag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void APE::File::read(bool readProperties)
+void APE::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -270,7 +274,7 @@ void APE::File::read(bool readProperties)
 
   // Look for APE audio properties
 
-  if(readProperties) {
+  if(readProperties && propertiesStyle != Properties::HeadOnly) {
 
     offset_t streamLength;
 
@@ -39,6 +39,7 @@
 #include "tdebug.h"
 #include "tfile.h"
 #include "tpropertymap.h"
+#include "tagutils.h"
 #include "apefooter.h"
 #include "apeitem.h"
 
@@ -401,7 +402,7 @@ void APE::Tag::parse(const ByteVector &data)
       APE::Item item;
       item.parse(data.mid(pos));
 
-      d->itemListMap.insert(item.key().upper(), item);
+      d->itemListMap.insert(Utils::internKey(item.key().upper()), item);
     }
     else {
       debug("APE::Tag::parse() - Skipped an item due to an invalid key.");
@@ -163,29 +163,49 @@ ASF::Picture ASF::Attribute::toPicture() const
 }
 
 String ASF::Attribute::parse(ASF::File &f, int kind)
+{
+  // Read the fixed fields first to find out the size of the descriptor,
+  // then parse it from memory.
+
+  ByteVector data;
+  if(kind == 0) {
+    data = f.readBlock(2);
+    data.append(f.readBlock(data.toUShort(false) + 4));
+    data.append(f.readBlock(data.toUShort(data.size() - 2, false)));
+  }
+  else {
+    data = f.readBlock(12);
+    data.append(f.readBlock(data.toUShort(4, false) + data.toUInt(8, false)));
+  }
+
+  unsigned int pos = 0;
+  return parse(data, pos, kind);
+}
+
+String ASF::Attribute::parse(const ByteVector &data, unsigned int &pos, int kind)
 {
   unsigned int size, nameLength;
   String name;
   d->pictureValue = Picture::fromInvalid();
   // extended content descriptor
   if(kind == 0) {
-    nameLength = readWORD(&f);
-    name = readString(&f, nameLength);
-    d->type = static_cast<ASF::Attribute::AttributeTypes>(readWORD(&f));
-    size = readWORD(&f);
+    nameLength = readWORD(data, pos);
+    name = readString(data, pos, nameLength);
+    d->type = static_cast<ASF::Attribute::AttributeTypes>(readWORD(data, pos));
+    size = readWORD(data, pos);
   }
   // metadata & metadata library
   else {
-    int temp = readWORD(&f);
+    int temp = readWORD(data, pos);
     // metadata library
     if(kind == 2) {
       d->language = temp;
     }
-    d->stream = readWORD(&f);
-    nameLength = readWORD(&f);
-    d->type = static_cast<ASF::Attribute::AttributeTypes>(readWORD(&f));
-    size = readDWORD(&f);
-    name = readString(&f, nameLength);
+    d->stream = readWORD(data, pos);
+    nameLength = readWORD(data, pos);
+    d->type = static_cast<ASF::Attribute::AttributeTypes>(readWORD(data, pos));
+    size = readDWORD(data, pos);
+    name = readString(data, pos, nameLength);
   }
 
   if(kind != 2 && size > 65535) {
@@ -194,33 +214,33 @@ String ASF::Attribute::parse(ASF::File &f, int kind)
 
   switch(d->type) {
   case WordType:
-    d->numericValue = readWORD(&f);
+    d->numericValue = readWORD(data, pos);
     break;
 
   case BoolType:
     if(kind == 0) {
-      d->numericValue = (readDWORD(&f) != 0);
+      d->numericValue = (readDWORD(data, pos) != 0);
     }
     else {
-      d->numericValue = (readWORD(&f) != 0);
+      d->numericValue = (readWORD(data, pos) != 0);
     }
     break;
 
   case DWordType:
-    d->numericValue = readDWORD(&f);
+    d->numericValue = readDWORD(data, pos);
     break;
 
   case QWordType:
-    d->numericValue = readQWORD(&f);
+    d->numericValue = readQWORD(data, pos);
     break;
 
   case UnicodeType:
-    d->stringValue = readString(&f, size);
+    d->stringValue = readString(data, pos, size);
     break;
 
   case BytesType:
   case GuidType:
-    d->byteVectorValue = f.readBlock(size);
+    d->byteVectorValue = readBytes(data, pos, size);
     break;
   }
 
@@ -186,6 +186,7 @@ namespace TagLib
 #ifndef DO_NOT_DOCUMENT
       /* THIS IS PRIVATE, DON'T TOUCH IT! */
       String parse(ASF::File &file, int kind = 0);
+      String parse(const ByteVector &data, unsigned int &pos, int kind = 0);
 #endif
 
       //! Returns the size of the stored data
@@ -25,6 +25,7 @@
 
 #include "asffile.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "tdebug.h"
@@ -50,6 +51,7 @@ public:
   class CodecListObject;
   class MetadataObject;
   class MetadataLibraryObject;
+  class PaddingObject;
 
   FilePrivate()
   {
@@ -61,6 +63,8 @@ public:
   FilePrivate(const FilePrivate &) = delete;
   FilePrivate &operator=(const FilePrivate &) = delete;
 
+  static void removePadding(List<BaseObject *> &objects);
+
   unsigned long long headerSize { 0 };
 
   std::unique_ptr<ASF::Tag> tag;
@@ -89,6 +93,10 @@ namespace
   const ByteVector contentEncryptionGuid("\xFB\xB3\x11\x22\x23\xBD\xD2\x11\xB4\xB7\x00\xA0\xC9\x55\xFC\x6E", 16);
   const ByteVector extendedContentEncryptionGuid("\x14\xE6\x8A\x29\x22\x26 \x17\x4C\xB9\x35\xDA\xE0\x7E\xE9\x28\x9C", 16);
   const ByteVector advancedContentEncryptionGuid("\xB6\x9B\x07\x7A\xA4\xDA\x12\x4E\xA5\xCA\x91\xD3\x8D\xC1\x1A\x8D", 16);
+  const ByteVector paddingGuid("\x74\xD4\x06\x18\xDF\xCA\x09\x45\xA4\xBA\x9A\xAB\xCB\x96\xAA\xE8", 16);
+
+  const long long MinPaddingSize = 4096;
+  const long long MaxPaddingSize = 1024 * 1024;
 }  // namespace
 
 class ASF::File::FilePrivate::BaseObject
@@ -97,7 +105,7 @@ public:
   ByteVector data;
   virtual ~BaseObject() = default;
   virtual ByteVector guid() const = 0;
-  virtual void parse(ASF::File *file, unsigned int size);
+  virtual void parse(ASF::File *file, const ByteVector &data);
   virtual ByteVector render(ASF::File *file);
 };
 
@@ -113,21 +121,21 @@ class ASF::File::FilePrivate::FilePropertiesObject : public ASF::File::FilePriva
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
 };
 
 class ASF::File::FilePrivate::StreamPropertiesObject : public ASF::File::FilePrivate::BaseObject
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
 };
 
 class ASF::File::FilePrivate::ContentDescriptionObject : public ASF::File::FilePrivate::BaseObject
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -136,7 +144,7 @@ class ASF::File::FilePrivate::ExtendedContentDescriptionObject : public ASF::Fil
 public:
   ByteVectorList attributeData;
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -145,7 +153,7 @@ class ASF::File::FilePrivate::MetadataObject : public ASF::File::FilePrivate::Ba
 public:
   ByteVectorList attributeData;
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -154,7 +162,7 @@ class ASF::File::FilePrivate::MetadataLibraryObject : public ASF::File::FilePriv
 public:
   ByteVectorList attributeData;
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -164,15 +172,21 @@ public:
   List<ASF::File::FilePrivate::BaseObject *> objects;
   HeaderExtensionObject();
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
   ByteVector render(ASF::File *file) override;
 };
 
+class ASF::File::FilePrivate::PaddingObject : public ASF::File::FilePrivate::BaseObject
+{
+public:
+  ByteVector guid() const override;
+};
+
 class ASF::File::FilePrivate::CodecListObject : public ASF::File::FilePrivate::BaseObject
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, unsigned int size) override;
+  void parse(ASF::File *file, const ByteVector &data) override;
 
 private:
   enum CodecType
@@ -183,13 +197,9 @@ private:
   };
 };
 
-void ASF::File::FilePrivate::BaseObject::parse(ASF::File *file, unsigned int size)
+void ASF::File::FilePrivate::BaseObject::parse(ASF::File * /*file*/, const ByteVector &objectData)
 {
-  data.clear();
-  if(size > 24 && size <= static_cast<unsigned int>(file->length()))
-    data = file->readBlock(size - 24);
-  else
-    data = ByteVector();
+  data = objectData;
 }
 
 ByteVector ASF::File::FilePrivate::BaseObject::render(ASF::File * /*file*/)
@@ -197,6 +207,19 @@ ByteVector ASF::File::FilePrivate::BaseObject::render(ASF::File * /*file*/)
   return guid() + ByteVector::fromLongLong(data.size() + 24, false) + data;
 }
 
+void ASF::File::FilePrivate::removePadding(List<BaseObject *> &objects)
+{
+  for(auto it = objects.begin(); it != objects.end();) {
+    if((*it)->guid() == paddingGuid) {
+      delete *it;
+      it = objects.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
 ASF::File::FilePrivate::UnknownObject::UnknownObject(const ByteVector &guid) : myGuid(guid)
 {
 }
@@ -211,9 +234,9 @@ ByteVector ASF::File::FilePrivate::FilePropertiesObject::guid() const
   return filePropertiesGuid;
 }
 
-void ASF::File::FilePrivate::FilePropertiesObject::parse(ASF::File *file, unsigned int size)
+void ASF::File::FilePrivate::FilePropertiesObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  BaseObject::parse(file, size);
+  BaseObject::parse(file, objectData);
   if(data.size() < 64) {
     debug("ASF::File::FilePrivate::FilePropertiesObject::parse() -- data is too short.");
     return;
@@ -229,9 +252,9 @@ ByteVector ASF::File::FilePrivate::StreamPropertiesObject::guid() const
   return streamPropertiesGuid;
 }
 
-void ASF::File::FilePrivate::StreamPropertiesObject::parse(ASF::File *file, unsigned int size)
+void ASF::File::FilePrivate::StreamPropertiesObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  BaseObject::parse(file, size);
+  BaseObject::parse(file, objectData);
   if(data.size() < 70) {
     debug("ASF::File::FilePrivate::StreamPropertiesObject::parse() -- data is too short.");
     return;
@@ -249,18 +272,19 @@ ByteVector ASF::File::FilePrivate::ContentDescriptionObject::guid() const
   return contentDescriptionGuid;
 }
 
-void ASF::File::FilePrivate::ContentDescriptionObject::parse(ASF::File *file, unsigned int /*size*/)
+void ASF::File::FilePrivate::ContentDescriptionObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  const int titleLength     = readWORD(file);
-  const int artistLength    = readWORD(file);
-  const int copyrightLength = readWORD(file);
-  const int commentLength   = readWORD(file);
-  const int ratingLength    = readWORD(file);
-  file->d->tag->setTitle(readString(file,titleLength));
-  file->d->tag->setArtist(readString(file,artistLength));
-  file->d->tag->setCopyright(readString(file,copyrightLength));
-  file->d->tag->setComment(readString(file,commentLength));
-  file->d->tag->setRating(readString(file,ratingLength));
+  unsigned int pos = 0;
+  const int titleLength     = readWORD(objectData, pos);
+  const int artistLength    = readWORD(objectData, pos);
+  const int copyrightLength = readWORD(objectData, pos);
+  const int commentLength   = readWORD(objectData, pos);
+  const int ratingLength    = readWORD(objectData, pos);
+  file->d->tag->setTitle(readString(objectData, pos, titleLength));
+  file->d->tag->setArtist(readString(objectData, pos, artistLength));
+  file->d->tag->setCopyright(readString(objectData, pos, copyrightLength));
+  file->d->tag->setComment(readString(objectData, pos, commentLength));
+  file->d->tag->setRating(readString(objectData, pos, ratingLength));
 }
 
 ByteVector ASF::File::FilePrivate::ContentDescriptionObject::render(ASF::File *file)
@@ -289,12 +313,13 @@ ByteVector ASF::File::FilePrivate::ExtendedContentDescriptionObject::guid() cons
   return extendedContentDescriptionGuid;
 }
 
-void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *file, unsigned int /*size*/)
+void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  int count = readWORD(file);
+  unsigned int pos = 0;
+  int count = readWORD(objectData, pos);
   while(count--) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file);
+    String name = Utils::internKey(attribute.parse(objectData, pos));
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -312,12 +337,13 @@ ByteVector ASF::File::FilePrivate::MetadataObject::guid() const
   return metadataGuid;
 }
 
-void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, unsigned int /*size*/)
+void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  int count = readWORD(file);
+  unsigned int pos = 0;
+  int count = readWORD(objectData, pos);
   while(count--) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file, 1);
+    String name = Utils::internKey(attribute.parse(objectData, pos, 1));
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -335,12 +361,13 @@ ByteVector ASF::File::FilePrivate::MetadataLibraryObject::guid() const
   return metadataLibraryGuid;
 }
 
-void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, unsigned int /*size*/)
+void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  int count = readWORD(file);
+  unsigned int pos = 0;
+  int count = readWORD(objectData, pos);
   while(count--) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file, 2);
+    String name = Utils::internKey(attribute.parse(objectData, pos, 2));
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -363,20 +390,17 @@ ByteVector ASF::File::FilePrivate::HeaderExtensionObject::guid() const
   return headerExtensionGuid;
 }
 
-void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, unsigned int /*size*/)
+void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  file->seek(18, File::Current);
-  long long dataSize = readDWORD(file);
-  long long dataPos = 0;
-  while(dataPos < dataSize) {
-    ByteVector guid = file->readBlock(16);
-    if(guid.size() != 16) {
-      file->setValid(false);
-      break;
-    }
+  unsigned int pos = 18;
+  const long long dataSize = readDWORD(objectData, pos);
+  const unsigned int dataEnd = pos + static_cast<unsigned int>(
+    std::min<long long>(dataSize, objectData.size() - pos));
+  while(pos < dataEnd) {
+    const ByteVector guid = readBytes(objectData, pos, 16);
     bool ok;
-    long long size = readQWORD(file, &ok);
-    if(!ok || size < 0 || size > dataSize - dataPos) {
+    const long long size = readQWORD(objectData, pos, &ok);
+    if(guid.size() != 16 || !ok || size < 24 || size - 24 > dataEnd - pos) {
       file->setValid(false);
       break;
     }
@@ -389,12 +413,14 @@ void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, unsig
       file->d->metadataLibraryObject = new MetadataLibraryObject();
       obj = file->d->metadataLibraryObject;
     }
+    else if(guid == paddingGuid) {
+      obj = new PaddingObject();
+    }
     else {
       obj = new UnknownObject(guid);
     }
-    obj->parse(file, static_cast<unsigned int>(size));
+    obj->parse(file, readBytes(objectData, pos, static_cast<unsigned int>(size - 24)));
     objects.append(obj);
-    dataPos += size;
   }
 }
 
@@ -408,14 +434,19 @@ ByteVector ASF::File::FilePrivate::HeaderExtensionObject::render(ASF::File *file
   return BaseObject::render(file);
 }
 
+ByteVector ASF::File::FilePrivate::PaddingObject::guid() const
+{
+  return paddingGuid;
+}
+
 ByteVector ASF::File::FilePrivate::CodecListObject::guid() const
 {
   return codecListGuid;
 }
 
-void ASF::File::FilePrivate::CodecListObject::parse(ASF::File *file, unsigned int size)
+void ASF::File::FilePrivate::CodecListObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  BaseObject::parse(file, size);
+  BaseObject::parse(file, objectData);
   if(data.size() <= 20) {
     debug("ASF::File::FilePrivate::CodecListObject::parse() -- data is too short.");
     return;
@@ -471,8 +502,12 @@ bool ASF::File::isSupported(IOStream *stream)
 {
   // An ASF file has to start with the designated GUID.
 
-  const ByteVector id = Utils::readHeader(stream, 16, false);
-  return (id == headerGuid);
+  return isSupported(Utils::readHeader(stream, 16, false));
+}
+
+bool ASF::File::isSupported(const ByteVector &data)
+{
+  return data.startsWith(headerGuid);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -581,11 +616,48 @@ bool ASF::File::save()
     }
   }
 
+  // Collect the free space in a single padding object at the end of the
+  // header extension.
+
+  FilePrivate::removePadding(d->objects);
+  FilePrivate::removePadding(d->headerExtensionObject->objects);
+
+  auto padding = new FilePrivate::PaddingObject();
+  d->headerExtensionObject->objects.append(padding);
+
   ByteVector data;
   for(const auto &object : std::as_const(d->objects)) {
     data.append(object->render(this));
   }
 
+  // Compute the amount of padding.  If the objects fit into the existing
+  // header, the media data does not have to be moved.
+
+  const auto originalSize = static_cast<long long>(d->headerSize) - 30;
+  long long paddingSize = originalSize - data.size();
+
+  if(paddingSize < 0) {
+    paddingSize = MinPaddingSize;
+  }
+  else {
+    // Padding won't increase beyond 1% of the file size or 1MB.
+
+    offset_t threshold = length() / 100;
+    threshold = std::max<offset_t>(threshold, MinPaddingSize);
+    threshold = std::min<offset_t>(threshold, MaxPaddingSize);
+
+    if(paddingSize > threshold)
+      paddingSize = MinPaddingSize;
+  }
+
+  if(paddingSize > 0) {
+    padding->data = ByteVector(static_cast<unsigned int>(paddingSize), '\0');
+    data.clear();
+    for(const auto &object : std::as_const(d->objects)) {
+      data.append(object->render(this));
+    }
+  }
+
   seek(16);
   writeBlock(ByteVector::fromLongLong(data.size() + 30, false));
   writeBlock(ByteVector::fromUInt(d->objects.size(), false));
@@ -616,29 +688,34 @@ void ASF::File::read()
   d->tag = std::make_unique<ASF::Tag>();
   d->properties = std::make_unique<ASF::Properties>();
 
-  bool ok;
-  d->headerSize = readQWORD(this, &ok);
-  if(!ok) {
+  // Read the whole header object at once and parse the objects in it from
+  // memory, instead of reading each field separately.
+
+  const ByteVector header = readBlock(14);
+  if(header.size() != 14) {
     setValid(false);
     return;
   }
-  int numObjects = readDWORD(this, &ok);
-  if(!ok) {
+
+  d->headerSize = header.toLongLong(0, false);
+  const unsigned int numObjects = header.toUInt(8, false);
+
+  if(d->headerSize < 30 || d->headerSize > static_cast<unsigned long long>(length())) {
+    debug("ASF::File::read(): Invalid header size.");
     setValid(false);
     return;
   }
-  seek(2, Current);
+
+  const ByteVector data = readBlock(static_cast<size_t>(d->headerSize - 30));
+  unsigned int pos = 0;
 
   FilePrivate::FilePropertiesObject   *filePropertiesObject   = nullptr;
   FilePrivate::StreamPropertiesObject *streamPropertiesObject = nullptr;
-  for(int i = 0; i < numObjects; i++) {
-    const ByteVector guid = readBlock(16);
-    if(guid.size() != 16) {
-      setValid(false);
-      break;
-    }
-    auto size = static_cast<long>(readQWORD(this, &ok));
-    if(!ok) {
+  for(unsigned int i = 0; i < numObjects; i++) {
+    const ByteVector guid = readBytes(data, pos, 16);
+    bool ok;
+    const long long size = readQWORD(data, pos, &ok);
+    if(guid.size() != 16 || !ok || size < 24 || size - 24 > data.size() - pos) {
       setValid(false);
       break;
     }
@@ -666,6 +743,9 @@ void ASF::File::read()
     else if(guid == codecListGuid) {
       obj = new FilePrivate::CodecListObject();
     }
+    else if(guid == paddingGuid) {
+      obj = new FilePrivate::PaddingObject();
+    }
     else {
       if(guid == contentEncryptionGuid ||
          guid == extendedContentEncryptionGuid ||
@@ -674,7 +754,7 @@ void ASF::File::read()
       }
       obj = new FilePrivate::UnknownObject(guid);
     }
-    obj->parse(this, size);
+    obj->parse(this, readBytes(data, pos, static_cast<unsigned int>(size - 24)));
     d->objects.append(obj);
   }
 
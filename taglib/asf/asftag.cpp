@@ -317,12 +317,13 @@ void ASF::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, String> reverseKeyMap;
-  if(reverseKeyMap.isEmpty()) {
+  static const Map<String, String> reverseKeyMap = [] {
+    Map<String, String> map;
     for(const auto &[k, t] : keyTranslation) {
-      reverseKeyMap[t] = k;
+      map[t] = k;
     }
-  }
+    return map;
+  }();
 
   const PropertyMap origProps = properties();
   for(const auto &[prop, _] : origProps) {
@@ -340,7 +341,7 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
         d->copyright.clear();
       }
       else {
-        d->attributeListMap.erase(reverseKeyMap[prop]);
+        d->attributeListMap.erase(reverseKeyMap.value(prop));
       }
     }
   }
@@ -348,7 +349,7 @@ PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
   PropertyMap ignoredProps;
   for(const auto &[prop, attributes] : props) {
     if(reverseKeyMap.contains(prop)) {
-      String name = reverseKeyMap[prop];
+      String name = reverseKeyMap.value(prop);
       removeItem(name);
       for(const auto &attribute : attributes) {
         addAttribute(name, attribute);
@@ -37,53 +37,66 @@ namespace TagLib
     namespace
     {
 
-      inline unsigned short readWORD(File *file, bool *ok = nullptr)
+      // Read little-endian values from a block of header data at pos and
+      // advance it.  A truncated value moves pos to the end of the data.
+
+      inline unsigned short readWORD(const ByteVector &data, unsigned int &pos, bool *ok = nullptr)
       {
-        const ByteVector v = file->readBlock(2);
-        if(v.size() != 2) {
+        if(data.size() < 2 || pos > data.size() - 2) {
+          pos = data.size();
           if(ok) *ok = false;
           return 0;
         }
         if(ok) *ok = true;
-        return v.toUShort(false);
+        pos += 2;
+        return data.toUShort(pos - 2, false);
       }
 
-      inline unsigned int readDWORD(File *file, bool *ok = nullptr)
+      inline unsigned int readDWORD(const ByteVector &data, unsigned int &pos, bool *ok = nullptr)
       {
-        const ByteVector v = file->readBlock(4);
-        if(v.size() != 4) {
+        if(data.size() < 4 || pos > data.size() - 4) {
+          pos = data.size();
           if(ok) *ok = false;
           return 0;
         }
         if(ok) *ok = true;
-        return v.toUInt(false);
+        pos += 4;
+        return data.toUInt(pos - 4, false);
       }
 
-      inline long long readQWORD(File *file, bool *ok = nullptr)
+      inline long long readQWORD(const ByteVector &data, unsigned int &pos, bool *ok = nullptr)
       {
-        const ByteVector v = file->readBlock(8);
-        if(v.size() != 8) {
+        if(data.size() < 8 || pos > data.size() - 8) {
+          pos = data.size();
           if(ok) *ok = false;
           return 0;
         }
         if(ok) *ok = true;
-        return v.toLongLong(false);
+        pos += 8;
+        return data.toLongLong(pos - 8, false);
+      }
+
+      inline ByteVector readBytes(const ByteVector &data, unsigned int &pos, unsigned int length)
+      {
+        const ByteVector block = data.mid(pos, length);
+        pos += block.size();
+        return block;
       }
 
-      inline String readString(File *file, int length)
+      inline String readString(const ByteVector &data, unsigned int &pos, unsigned int length)
       {
-        ByteVector data = file->readBlock(length);
-        unsigned int size = data.size();
+        ByteVector block = readBytes(data, pos, length);
+        unsigned int size = block.size();
         while (size >= 2) {
-          if(data[size - 1] != '\0' || data[size - 2] != '\0') {
+          if(block[size - 1] != '\0' || block[size - 2] != '\0') {
             break;
           }
           size -= 2;
         }
-        if(size != data.size()) {
-          data.resize(size);
+        if(size != block.size()) {
+          block.resize(size);
         }
-        return String(data, String::UTF16LE);
+        return String(block, String::UTF16LE);
       }
 
       inline ByteVector renderString(const String &str, bool includeLength = false)
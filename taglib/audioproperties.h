@@ -59,7 +59,44 @@ namespace TagLib {
       //! Read more of the file and make better values guesses
       Average,
       //! Read as much of the file as needed to report accurate values
-      Accurate
+      Accurate,
+      /*!
+       * Do not read the audio properties, and only read the tags at the end
+       * of the file (ID3v1 and APE) if the format has no tags elsewhere.
+       * This avoids touching the end of the file, which is expensive e.g. on
+       * network file systems.
+       *
+       * The I/O done with this style depends on the format.  The numbers
+       * below were measured with FileRef on the files of the test suite and
+       * include the detection of the file type.
+       *  - MPEG and TrueAudio read the ID3v2 tag.  If there is one, the end
+       *    of the file is not read and the file can not be saved, since the
+       *    tags which were not read would be lost.  Otherwise the ID3v1 and
+       *    APE tags are read and the file is saved normally.  An MP3 file
+       *    with a 0.5 KiB ID3v2 tag takes 4 reads of 525 bytes, compared
+       *    with 13 reads of 2705 bytes with Average.
+       *  - FLAC reads the metadata blocks at the beginning of the file, but
+       *    not an ID3v1 tag at the end.  It can not be saved either.
+       *  - APE, WavPack and Musepack keep their tags at the end of the file.
+       *    They read the ID3v1 tag (an 8 byte probe 131 bytes from the end,
+       *    then 128 bytes) and the APE tag (the 32 byte footer, then the
+       *    tag), but not the audio properties, and save normally.  A
+       *    WavPack file with a 0.2 KiB APE tag takes 5 reads of 247 bytes,
+       *    compared with 6 reads of 279 bytes.
+       *  - Ogg reads the pages up to the end of the comment header.
+       *  - MP4 reads the headers of all top-level atoms, which are spread
+       *    over the whole file, and the 'moov' atom.
+       *  - ASF reads the header object.
+       *  - WAV, AIFF and DSF are read as with Average.  RIFF walks the
+       *    chunk headers up to the end of the file, including trailing ID3
+       *    and LIST chunks, and DSF follows its pointer to the metadata at
+       *    the end of the file.
+       *
+       * FileRef does not read the audio properties with this style.  If a
+       * File is constructed directly, most formats read the audio properties
+       * as with Average when asked to.
+       */
+      HeadOnly
     };
 
     /*!
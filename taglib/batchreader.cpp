@@ -0,0 +1,153 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "batchreader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "fileref.h"
+
+using namespace TagLib;
+
+class BatchReader::BatchReaderPrivate
+{
+public:
+  unsigned int threadCount { 1 };
+  bool readAudioProperties { true };
+  AudioProperties::ReadStyle audioPropertiesStyle { AudioProperties::Average };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+BatchReader::BatchReader(unsigned int threadCount,
+                         bool readAudioProperties,
+                         AudioProperties::ReadStyle audioPropertiesStyle) :
+  d(std::make_unique<BatchReaderPrivate>())
+{
+  if(threadCount == 0)
+    threadCount = std::thread::hardware_concurrency();
+
+  d->threadCount = std::max(threadCount, 1U);
+  d->readAudioProperties = readAudioProperties;
+  d->audioPropertiesStyle = audioPropertiesStyle;
+}
+
+BatchReader::~BatchReader() = default;
+
+unsigned int BatchReader::threadCount() const
+{
+  return d->threadCount;
+}
+
+void BatchReader::read(const List<FileName> &fileNames, const Callback &callback) const
+{
+  const std::vector<FileName> names(fileNames.begin(), fileNames.end());
+
+  // Each worker takes the next unread file from a shared counter, so that a
+  // thread which is done with a small file immediately picks up more work.
+
+  std::atomic<size_t> next(0);
+  std::mutex callbackMutex;
+
+  // An exception thrown while reading a file or by the callback stops the
+  // workers from taking more files and is rethrown once all of them have
+  // finished.  It must not escape a thread, which would terminate the program.
+
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+
+  const auto read = [&](size_t i) {
+    Result result {};
+    result.index = static_cast<unsigned int>(i);
+
+    const FileRef ref(names[i], d->readAudioProperties, d->audioPropertiesStyle);
+    if(!ref.isNull()) {
+      result.isValid = true;
+      result.properties = ref.file()->properties();
+
+      if(const AudioProperties *properties = ref.audioProperties()) {
+        result.lengthInMilliseconds = properties->lengthInMilliseconds();
+        result.bitrate = properties->bitrate();
+        result.sampleRate = properties->sampleRate();
+        result.channels = properties->channels();
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(callbackMutex);
+    callback(names[i], result);
+  };
+
+  const auto worker = [&] {
+    for(size_t i = next++; i < names.size(); i = next++) {
+      try {
+        read(i);
+      }
+      catch(...) {
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if(!exception)
+          exception = std::current_exception();
+        next = names.size();
+      }
+    }
+  };
+
+  // The calling thread is one of the workers.  The threads are joined even
+  // if starting one of them fails.
+
+  struct Joiner
+  {
+    ~Joiner()
+    {
+      for(auto &thread : threads)
+        thread.join();
+    }
+    std::vector<std::thread> threads;
+  };
+
+  const size_t threadCount = std::min<size_t>(d->threadCount, names.size());
+
+  {
+    Joiner joiner;
+    try {
+      for(size_t i = 1; i < threadCount; ++i)
+        joiner.threads.emplace_back(worker);
+    }
+    catch(...) {
+      next = names.size();
+      throw;
+    }
+
+    worker();
+  }
+
+  if(exception)
+    std::rethrow_exception(exception);
+}
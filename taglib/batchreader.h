@@ -0,0 +1,135 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_BATCHREADER_H
+#define TAGLIB_BATCHREADER_H
+
+#include <functional>
+
+#include "tiostream.h"
+#include "tlist.h"
+#include "tpropertymap.h"
+#include "taglib_export.h"
+#include "audioproperties.h"
+
+namespace TagLib {
+
+  //! Reads the meta data of many files using several threads
+
+  /*!
+   * BatchReader opens a list of files with FileRef using a pool of worker
+   * threads and reports the properties and the audio properties of each file
+   * as soon as it has been read.  This is useful for scanning whole music
+   * libraries, where a single thread spends most of its time waiting for I/O.
+   *
+   * \code
+   * TagLib::BatchReader reader;
+   * reader.read(fileNames, [](TagLib::FileName fileName,
+   *                           const TagLib::BatchReader::Result &result) {
+   *   if(result.isValid)
+   *     std::cout << result.properties["TITLE"].toString() << std::endl;
+   * });
+   * \endcode
+   *
+   * The global settings of TagLib, i.e. the file type resolvers, the string
+   * handlers of ID3v1, ID3v2 and RIFF INFO tags and the defaults of
+   * ID3v2::FrameFactory::instance(), may be changed while files are read, but
+   * a reader may then pick up either the old or the new setting.  Custom file
+   * type resolvers and string handlers have to be safe to call from several
+   * threads at once.
+   */
+
+  class TAGLIB_EXPORT BatchReader
+  {
+  public:
+    /*!
+     * The meta data of a single file.
+     */
+    struct Result {
+      //! The index of the file in the list passed to read().
+      unsigned int index;
+      //! True if the file could be opened and its type was recognized.
+      bool isValid;
+      //! The properties of the file's tag, see File::properties().
+      PropertyMap properties;
+      //! The length in milliseconds, or 0 if not available.
+      int lengthInMilliseconds;
+      //! The bitrate in kb/s, or 0 if not available.
+      int bitrate;
+      //! The sample rate in Hz, or 0 if not available.
+      int sampleRate;
+      //! The number of audio channels, or 0 if not available.
+      int channels;
+    };
+
+    /*!
+     * The function called with the result of each file.
+     */
+    using Callback = std::function<void(FileName fileName, const Result &result)>;
+
+    /*!
+     * Constructs a BatchReader which reads files using \a threadCount threads.
+     * If \a threadCount is 0 the number of hardware threads is used.  If
+     * \a readAudioProperties is true the audio properties are read with the
+     * given \a audioPropertiesStyle.
+     */
+    explicit BatchReader(unsigned int threadCount = 0,
+                         bool readAudioProperties = true,
+                         AudioProperties::ReadStyle audioPropertiesStyle = AudioProperties::Average);
+
+    /*!
+     * Destroys this BatchReader instance.
+     */
+    ~BatchReader();
+
+    BatchReader(const BatchReader &) = delete;
+    BatchReader &operator=(const BatchReader &) = delete;
+
+    /*!
+     * Returns the number of threads used to read files.
+     */
+    unsigned int threadCount() const;
+
+    /*!
+     * Reads all files in \a fileNames and calls \a callback once for each of
+     * them.  The files are read in parallel, so the callback is called in no
+     * particular order and from the worker threads, but never concurrently.
+     * This returns when all files have been read.
+     *
+     * If reading a file or the callback throws an exception, no further files
+     * are read and the first exception is rethrown once all threads have
+     * finished.
+     *
+     * \note The file names have to stay valid until this returns.
+     */
+    void read(const List<FileName> &fileNames, const Callback &callback) const;
+
+  private:
+    class BatchReaderPrivate;
+    std::unique_ptr<BatchReaderPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
@@ -55,10 +55,15 @@ public:
 };
 
 bool DSF::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 4, false));
+}
+
+bool DSF::File::isSupported(const ByteVector &data)
 {
   // A DSF file has to start with "DSD "
-  const ByteVector id = Utils::readHeader(stream, 4, false);
-  return id.startsWith("DSD ");
+
+  return (data.startsWith("DSD "));
 }
 
 DSF::File::File(FileName file, bool readProperties,
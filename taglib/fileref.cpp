@@ -30,10 +30,13 @@
 #include "fileref.h"
 
 #include <cstring>
+#include <mutex>
 #include <utility>
 
 #include "tfilestream.h"
+#include "tmmapfilestream.h"
 #include "tdebug.h"
+#include "tagutils.h"
 #include "aifffile.h"
 #include "apefile.h"
 #include "asffile.h"
@@ -53,6 +56,8 @@
 #include "wavpackfile.h"
 #include "xmfile.h"
 #include "dsffile.h"
+#include "id3v2header.h"
+#include "mpegutils.h"
 
 using namespace TagLib;
 
@@ -67,6 +72,16 @@ class FileRef::StreamTypeResolver::StreamTypeResolverPrivate
 namespace
 {
   List<const FileRef::FileTypeResolver *> fileTypeResolvers;
+  std::mutex fileTypeResolversMutex;
+
+  // Returns a snapshot of the resolvers, so that files can be opened in
+  // several threads while another one adds a resolver.
+
+  List<const FileRef::FileTypeResolver *> resolvers()
+  {
+    std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+    return fileTypeResolvers;
+  }
 
   // Detect the file type by user-defined resolvers.
 
@@ -80,7 +95,8 @@ namespace
     if(::strlen(fileName) == 0)
       return nullptr;
 #endif
-    for(const auto &resolver : std::as_const(fileTypeResolvers)) {
+    const auto fileResolvers = resolvers();
+    for(const auto &resolver : fileResolvers) {
       File *file = resolver->createFile(fileName, readAudioProperties, audioPropertiesStyle);
       if(file)
         return file;
@@ -92,7 +108,8 @@ namespace
   File *detectByResolvers(IOStream* stream, bool readAudioProperties,
                           AudioProperties::ReadStyle audioPropertiesStyle)
   {
-    for(const auto &resolver : std::as_const(fileTypeResolvers)) {
+    const auto fileResolvers = resolvers();
+    for(const auto &resolver : fileResolvers) {
       if(auto streamResolver = dynamic_cast<const FileRef::StreamTypeResolver *>(resolver)) {
         if(File *file = streamResolver->createFileFromStream(
              stream, readAudioProperties, audioPropertiesStyle))
@@ -179,42 +196,72 @@ namespace
     return nullptr;
   }
 
+  // The number of bytes read to detect the file type.  This matches the
+  // buffer size used by the isSupported() methods.
+
+  constexpr unsigned int sniffLength = 1024;
+
+  // Returns true if the buffer contains anything which looks like an MPEG
+  // frame sync.
+
+  bool containsFrameSync(const ByteVector &data)
+  {
+    for(unsigned int i = 0; i + 1 < data.size(); ++i) {
+      if(MPEG::isFrameSync(data, i))
+        return true;
+    }
+    return false;
+  }
+
   // Detect the file type based on the actual content of the stream.
 
   File *detectByContent(IOStream *stream, bool readAudioProperties,
                         AudioProperties::ReadStyle audioPropertiesStyle)
   {
+    // Read the beginning of the stream once and pass it to the isSupported()
+    // overloads which take the data.  "body" is the data following an ID3v2
+    // tag, if there is one.  Only MPEG needs to read more, since a frame
+    // sync alone is not reliable.
+
+    const ByteVector head = Utils::readHeader(stream, sniffLength, false);
+    if(head.isEmpty())
+      return nullptr;
+
+    ByteVector body = head;
+    if(head.startsWith(ID3v2::Header::fileIdentifier()))
+      body = Utils::readHeader(stream, sniffLength, true);
+
     File *file = nullptr;
 
-    if(MPEG::File::isSupported(stream))
+    if(containsFrameSync(body) && MPEG::File::isSupported(stream))
       file = new MPEG::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Vorbis::File::isSupported(stream))
+    else if(Ogg::Vorbis::File::isSupported(head))
       file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::FLAC::File::isSupported(stream))
+    else if(Ogg::FLAC::File::isSupported(head))
       file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(FLAC::File::isSupported(stream))
+    else if(FLAC::File::isSupported(body))
       file = new FLAC::File(stream, ID3v2::FrameFactory::instance(), readAudioProperties, audioPropertiesStyle);
-    else if(MPC::File::isSupported(stream))
+    else if(MPC::File::isSupported(head))
       file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(WavPack::File::isSupported(stream))
+    else if(WavPack::File::isSupported(head))
       file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Speex::File::isSupported(stream))
+    else if(Ogg::Speex::File::isSupported(head))
       file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(Ogg::Opus::File::isSupported(stream))
+    else if(Ogg::Opus::File::isSupported(head))
       file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(TrueAudio::File::isSupported(stream))
+    else if(TrueAudio::File::isSupported(body))
       file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(MP4::File::isSupported(stream))
+    else if(MP4::File::isSupported(head))
       file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(ASF::File::isSupported(stream))
+    else if(ASF::File::isSupported(head))
       file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::AIFF::File::isSupported(stream))
+    else if(RIFF::AIFF::File::isSupported(head))
       file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(RIFF::WAV::File::isSupported(stream))
+    else if(RIFF::WAV::File::isSupported(head))
       file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(APE::File::isSupported(stream))
+    else if(APE::File::isSupported(body))
       file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
-    else if(DSF::File::isSupported(stream))
+    else if(DSF::File::isSupported(head))
       file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
 
     // isSupported() only does a quick check, so double check the file here.
@@ -335,6 +382,14 @@ FileRef::FileRef(FileName fileName, bool readAudioProperties,
   parse(fileName, readAudioProperties, audioPropertiesStyle);
 }
 
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 File::StreamBackend backend) :
+  d(std::make_shared<FileRefPrivate>())
+{
+  parse(fileName, readAudioProperties, audioPropertiesStyle, backend);
+}
+
 FileRef::FileRef(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle) :
   d(std::make_shared<FileRefPrivate>())
 {
@@ -385,10 +440,17 @@ bool FileRef::save()
 
 const FileRef::FileTypeResolver *FileRef::addFileTypeResolver(const FileRef::FileTypeResolver *resolver) // static
 {
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
   fileTypeResolvers.prepend(resolver);
   return resolver;
 }
 
+void FileRef::clearFileTypeResolvers() // static
+{
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+  fileTypeResolvers.clear();
+}
+
 StringList FileRef::defaultFileExtensions()
 {
   StringList l;
@@ -464,8 +526,27 @@ File *FileRef::create(FileName fileName, bool readAudioProperties,
 ////////////////////////////////////////////////////////////////////////////////
 
 void FileRef::parse(FileName fileName, bool readAudioProperties,
-                    AudioProperties::ReadStyle audioPropertiesStyle)
+                    AudioProperties::ReadStyle audioPropertiesStyle,
+                    File::StreamBackend backend)
 {
+  // A mapped file is resolved like any other stream, but owned by this
+  // FileRef.
+
+  if(backend == File::MemoryMapped) {
+    d->stream = new MMapFileStream(fileName);
+    parse(d->stream, readAudioProperties, audioPropertiesStyle);
+    if(!d->file) {
+      delete d->stream;
+      d->stream = nullptr;
+    }
+    return;
+  }
+
+  // The audio properties may require reading the end of the file.
+
+  if(audioPropertiesStyle == AudioProperties::HeadOnly)
+    readAudioProperties = false;
+
   // Try user-defined resolvers.
 
   d->file = detectByResolvers(fileName, readAudioProperties, audioPropertiesStyle);
@@ -494,6 +575,11 @@ void FileRef::parse(FileName fileName, bool readAudioProperties,
 void FileRef::parse(IOStream *stream, bool readAudioProperties,
                     AudioProperties::ReadStyle audioPropertiesStyle)
 {
+  // The audio properties may require reading the end of the file.
+
+  if(audioPropertiesStyle == AudioProperties::HeadOnly)
+    readAudioProperties = false;
+
   // Try user-defined stream resolvers.
 
   d->file = detectByResolvers(stream, readAudioProperties, audioPropertiesStyle);
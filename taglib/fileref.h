@@ -159,6 +159,17 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Create a FileRef from \a fileName like
+     * FileRef(FileName, bool, AudioProperties::ReadStyle), but access the file
+     * through the stream selected by \a backend.  With File::MemoryMapped the
+     * file is mapped read only, so it cannot be saved.
+     */
+    FileRef(FileName fileName,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            File::StreamBackend backend);
+
     /*!
      * Construct a FileRef from an opened \a IOStream.  If \a readAudioProperties
      * is true then the audio properties will be read using \a audioPropertiesStyle.
@@ -247,6 +258,14 @@ namespace TagLib {
      */
     static const FileTypeResolver *addFileTypeResolver(const FileTypeResolver *resolver);
 
+    /*!
+     * Removes all FileTypeResolvers added with addFileTypeResolver().  The
+     * resolvers are not deleted.
+     *
+     * \see addFileTypeResolver()
+     */
+    static void clearFileTypeResolvers();
+
     /*!
      * As is mentioned elsewhere in this class's documentation, the default file
      * type resolution code provided by TagLib only works by comparing file
@@ -308,7 +327,8 @@ namespace TagLib {
                         AudioProperties::ReadStyle audioPropertiesStyle = AudioProperties::Average);
 
   private:
-    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
+    void parse(FileName fileName, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle,
+               File::StreamBackend backend = File::Buffered);
     void parse(IOStream *stream, bool readAudioProperties, AudioProperties::ReadStyle audioPropertiesStyle);
 
     class FileRefPrivate;
@@ -48,6 +48,60 @@ namespace
   const long MaxPaddingLegnth = 1024 * 1024;
 
   const char LastBlockFlag = '\x80';
+
+  // Stands in for a picture block which has not been read yet.  Pictures are
+  // often large and not needed when only the text tags are of interest.
+
+  class PictureReference : public FLAC::MetadataBlock
+  {
+  public:
+    PictureReference(offset_t offset, unsigned int length) :
+      offset(offset),
+      length(length)
+    {
+    }
+
+    int code() const override
+    {
+      return FLAC::MetadataBlock::Picture;
+    }
+
+    ByteVector render() const override
+    {
+      return ByteVector();
+    }
+
+    const offset_t offset;
+    const unsigned int length;
+  };
+
+  // Replaces the picture references in blocks by the pictures read from file.
+  void loadPictures(FLAC::File *file, List<FLAC::MetadataBlock *> &blocks)
+  {
+    for(auto it = blocks.begin(); it != blocks.end();) {
+      const auto reference = dynamic_cast<PictureReference *>(*it);
+      if(!reference) {
+        ++it;
+        continue;
+      }
+
+      file->seek(reference->offset);
+      const ByteVector data = file->readBlock(reference->length);
+
+      auto picture = new FLAC::Picture();
+      if(data.size() == reference->length && picture->parse(data)) {
+        *it = picture;
+        ++it;
+      }
+      else {
+        debug("FLAC::File -- invalid picture found, discarding");
+        delete picture;
+        it = blocks.erase(it);
+      }
+
+      delete reference;
+    }
+  }
 }  // namespace
 
 class FLAC::File::FilePrivate
@@ -64,6 +118,7 @@ public:
   long ID3v2OriginalSize { 0 };
 
   offset_t ID3v1Location { -1 };
+  bool headOnly { false };
 
   TagUnion tag;
 
@@ -81,41 +136,45 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool FLAC::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, bufferSize(), true));
+}
+
+bool FLAC::File::isSupported(const ByteVector &data)
 {
   // A FLAC file has an ID "fLaC" somewhere. An ID3v2 tag may precede.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), true);
-  return (buffer.find("fLaC") >= 0);
+  return (data.find("fLaC") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-FLAC::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+FLAC::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 FLAC::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 FLAC::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 FLAC::File::~File() = default;
@@ -152,6 +211,11 @@ bool FLAC::File::save()
     return false;
   }
 
+  if(d->headOnly) {
+    debug("FLAC::File::save() -- Cannot save a file opened with HeadOnly.");
+    return false;
+  }
+
   if(!isValid()) {
     debug("FLAC::File::save() -- Trying to save invalid file.");
     return false;
@@ -163,6 +227,10 @@ bool FLAC::File::save()
 
   d->xiphCommentData = xiphComment()->render(false);
 
+  // The pictures have to be read before the file is modified.
+
+  loadPictures(this, d->blocks);
+
   // Replace metadata blocks
 
   MetadataBlock *commentBlock =
@@ -219,7 +287,10 @@ bool FLAC::File::save()
   data.append(paddingHeader);
   data.resize(static_cast<unsigned int>(data.size() + paddingLength));
 
-  // Write the data to the file
+  // Write the data to the file.  All the changes are collected and applied
+  // at once, so that the audio data is moved only once.
+
+  beginEdit();
 
   insert(data, d->flacStart, originalLength);
 
@@ -270,15 +341,11 @@ bool FLAC::File::save()
 
     // ID3v1 tag is not empty. Update the old one or create a new one.
 
-    if(d->ID3v1Location >= 0) {
-      seek(d->ID3v1Location);
-    }
-    else {
-      seek(0, End);
-      d->ID3v1Location = tell();
-    }
+    if(d->ID3v1Location < 0)
+      d->ID3v1Location = length();
 
-    writeBlock(ID3v1Tag()->render());
+    data = ID3v1Tag()->render();
+    insert(data, d->ID3v1Location, data.size());
   }
   else {
 
@@ -290,6 +357,8 @@ bool FLAC::File::save()
     }
   }
 
+  commitEdit();
+
   return true;
 }
 
@@ -310,6 +379,8 @@ Ogg::XiphComment *FLAC::File::xiphComment(bool create)
 
 List<FLAC::Picture *> FLAC::File::pictureList()
 {
+  loadPictures(this, d->blocks);
+
   List<Picture *> pictures;
   for(const auto &block : std::as_const(d->blocks)) {
     if(auto picture = dynamic_cast<Picture *>(block)) {
@@ -337,7 +408,7 @@ void FLAC::File::removePicture(Picture *picture, bool del)
 void FLAC::File::removePictures()
 {
   for(auto it = d->blocks.begin(); it != d->blocks.end(); ) {
-    if(dynamic_cast<Picture *>(*it)) {
+    if((*it)->code() == MetadataBlock::Picture) {
       delete *it;
       it = d->blocks.erase(it);
     }
@@ -380,7 +451,7 @@ bool FLAC::File::hasID3v2Tag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void FLAC::File::read(bool readProperties)
+void FLAC::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -391,9 +462,10 @@ void FLAC::File::read(bool readProperties)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
-  // Look for an ID3v1 tag
+  // Look for an ID3v1 tag, unless only the beginning of the file is read
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->headOnly = (propertiesStyle == Properties::HeadOnly);
+  d->ID3v1Location = d->headOnly ? -1 : Utils::findID3v1(this);
 
   if(d->ID3v1Location >= 0)
     d->tag.set(FlacID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
@@ -410,7 +482,7 @@ void FLAC::File::read(bool readProperties)
   else
     d->tag.set(FlacXiphIndex, new Ogg::XiphComment());
 
-  if(readProperties) {
+  if(readProperties && !d->headOnly) {
 
     // First block should be the stream_info metadata
 
@@ -453,6 +525,8 @@ void FLAC::File::scan()
   nextBlockOffset += 4;
   d->flacStart = nextBlockOffset;
 
+  const offset_t fileLength = length();
+
   while(true) {
 
     seek(nextBlockOffset);
@@ -495,8 +569,13 @@ void FLAC::File::scan()
       return;
     }
 
-    const ByteVector data = readBlock(blockLength);
-    if(data.size() != blockLength) {
+    // Pictures are read when they are accessed and padding is not needed.
+
+    ByteVector data;
+    if(blockType != MetadataBlock::Picture && blockType != MetadataBlock::Padding)
+      data = readBlock(blockLength);
+
+    if(data.size() != blockLength && nextBlockOffset + 4 + blockLength > fileLength) {
       debug("FLAC::File::scan() -- Failed to read a metadata block");
       setValid(false);
       return;
@@ -515,14 +594,7 @@ void FLAC::File::scan()
       }
     }
     else if(blockType == MetadataBlock::Picture) {
-      auto picture = new FLAC::Picture();
-      if(picture->parse(data)) {
-        block = picture;
-      }
-      else {
-        debug("FLAC::File::scan() -- invalid picture found, discarding");
-        delete picture;
-      }
+      block = new PictureReference(nextBlockOffset + 4, blockLength);
     }
     else if(blockType == MetadataBlock::Padding) {
       // Skip all padding blocks.
@@ -86,7 +86,8 @@ namespace TagLib {
        * Constructs a FLAC file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        *
        * \deprecated This constructor will be dropped in favor of the one below
        * in a future version.
@@ -101,7 +102,8 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       // BIC: merge with the above constructor, kept for source compatibility
       File(FileName file, ID3v2::FrameFactory *frameFactory,
@@ -118,7 +120,8 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
@@ -302,8 +305,16 @@ namespace TagLib {
        */
       static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns whether or not a file whose data following an ID3v2 tag, if
+       * there is one, starts with \a data can be opened as a FLAC file.
+       * This does the same check as isSupported(IOStream *) on data which
+       * has already been read.
+       */
+      static bool isSupported(const ByteVector &data);
+
     private:
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       void scan();
 
       class FilePrivate;
@@ -25,7 +25,7 @@
 
 #include "mp4atom.h"
 
-#include <climits>
+#include <algorithm>
 #include <utility>
 
 #include "tdebug.h"
@@ -38,23 +38,63 @@ namespace {
     "stbl", "minf", "moof", "traf", "trak",
     "stsd"
   };
+
+  // Returns the header of the atom at position, which is at most 16 bytes
+  // long.  The file is read in blocks kept in buffer, so that walking
+  // consecutive small atoms does not need a read per header.
+
+  ByteVector readHeader(File *file, offset_t position, ByteVector &buffer, offset_t &bufferOffset)
+  {
+    constexpr unsigned int headerLength = 16;
+    constexpr unsigned int blockLength = 4096;
+
+    if(position < bufferOffset || position + headerLength > bufferOffset + buffer.size()) {
+      file->seek(position);
+      buffer = file->readBlock(blockLength);
+      bufferOffset = position;
+    }
+    return buffer.mid(static_cast<unsigned int>(position - bufferOffset), headerLength);
+  }
 } // namespace
 
-MP4::Atom::Atom(File *file)
-  : offset(file->tell())
+MP4::Atom::Atom(File *file) :
+  offset(file->tell()),
+  length(0)
 {
   children.setAutoDelete(true);
 
-  ByteVector header = file->readBlock(8);
-  if(header.size() != 8) {
+  ByteVector buffer;
+  offset_t bufferOffset = 0;
+  file->seek(read(file, buffer, bufferOffset, false));
+}
+
+MP4::Atom::Atom(offset_t offset) :
+  offset(offset),
+  length(0)
+{
+  children.setAutoDelete(true);
+}
+
+MP4::Atom::~Atom() = default;
+
+offset_t
+MP4::Atom::read(File *file, ByteVector &buffer, offset_t &bufferOffset, bool readFragment)
+{
+  // Returns the position after the last child, which is where the next
+  // atom is expected.  For broken files it can be beyond the end of this
+  // atom.  The children of fragments ('moof') are only read if
+  // readFragment is true.
+
+  const ByteVector header = readHeader(file, offset, buffer, bufferOffset);
+  if(header.size() < 8) {
     // The atom header must be 8 bytes long, otherwise there is either
     // trailing garbage or the file is truncated
     debug("MP4: Couldn't read 8 bytes of data for atom header");
     length = 0;
-    file->seek(0, File::End);
-    return;
+    return file->length();
   }
 
+  offset_t headerLength = 8;
   length = header.toUInt();
 
   if(length == 0) {
@@ -63,24 +103,21 @@ MP4::Atom::Atom(File *file)
   }
   else if(length == 1) {
     // The atom has a 64-bit length.
-    const long long longLength = file->readBlock(8).toLongLong();
-    if(longLength <= LONG_MAX) {
-      // The actual length fits in long. That's always the case if long is 64-bit.
-      length = static_cast<long>(longLength);
+    if(header.size() == 16) {
+      length = static_cast<offset_t>(header.toLongLong(8U));
+      headerLength = 16;
     }
     else {
-      debug("MP4: 64-bit atoms are not supported");
+      debug("MP4: Truncated 64-bit atom header");
       length = 0;
-      file->seek(0, File::End);
-      return;
+      return file->length();
     }
   }
 
-  if(length < 8 || length > file->length() - offset) {
+  if(length < headerLength || length > file->length() - offset) {
     debug("MP4: Invalid atom size");
     length = 0;
-    file->seek(0, File::End);
-    return;
+    return file->length();
   }
 
   name = header.mid(4, 4);
@@ -89,42 +126,45 @@ MP4::Atom::Atom(File *file)
     if((ch < ' ' || ch > '~') && ch != '\251') {
       debug("MP4: Invalid atom type");
       length = 0;
-      file->seek(0, File::End);
+      return file->length();
     }
   }
 
-  for(auto c : containers) {
-    if(name == c) {
-      if(name == "meta") {
-        offset_t posAfterMeta = file->tell();
-        static constexpr std::array metaChildrenNames {
-          "hdlr", "ilst", "mhdr", "ctry", "lang"
-        };
-        // meta is not a full atom (i.e. not followed by version, flags). It
-        // is followed by the size and type of the first child atom.
-        auto metaIsFullAtom = std::none_of(metaChildrenNames.begin(), metaChildrenNames.end(),
-          [nextSize = file->readBlock(8).mid(4, 4)](const auto &child) { return nextSize == child; });
-        // Only skip next four bytes, which contain version and flags, if meta
-        // is a full atom.
-        file->seek(posAfterMeta + (metaIsFullAtom ? 4 : 0));
-      }
-      else if(name == "stsd") {
-        file->seek(8, File::Current);
-      }
-      while(file->tell() < offset + length) {
-        auto child = new MP4::Atom(file);
-        children.append(child);
-        if(child->length == 0)
-          return;
-      }
-      return;
-    }
+  if(std::none_of(containers.begin(), containers.end(),
+                  [this](const auto &c) { return name == c; }) ||
+     (name == "moof" && !readFragment)) {
+    return offset + length;
   }
 
-  file->seek(offset + length);
-}
+  offset_t position = offset + headerLength;
 
-MP4::Atom::~Atom() = default;
+  if(name == "meta") {
+    static constexpr std::array metaChildrenNames {
+      "hdlr", "ilst", "mhdr", "ctry", "lang"
+    };
+    // meta is not a full atom (i.e. not followed by version, flags). It
+    // is followed by the size and type of the first child atom.
+    auto metaIsFullAtom = std::none_of(metaChildrenNames.begin(), metaChildrenNames.end(),
+      [nextSize = readHeader(file, position, buffer, bufferOffset).mid(4, 4)](const auto &child) { return nextSize == child; });
+    // Only skip next four bytes, which contain version and flags, if meta
+    // is a full atom.
+    if(metaIsFullAtom)
+      position += 4;
+  }
+  else if(name == "stsd") {
+    position += 8;
+  }
+
+  while(position < offset + length) {
+    auto child = new MP4::Atom(position);
+    children.append(child);
+    position = child->read(file, buffer, bufferOffset, readFragment);
+    if(child->length == 0)
+      return file->length();
+  }
+
+  return position;
+}
 
 MP4::Atom *
 MP4::Atom::find(const char *name1, const char *name2, const char *name3, const char *name4)
@@ -174,19 +214,37 @@ MP4::Atoms::Atoms(File *file)
 {
   atoms.setAutoDelete(true);
 
-  file->seek(0, File::End);
-  offset_t end = file->tell();
-  file->seek(0);
-  while(file->tell() + 8 <= end) {
-    auto atom = new MP4::Atom(file);
+  // Only the headers are read, so that 'mdat' is skipped without reading
+  // any of its contents.  The children of fragments are only read by
+  // readFragments(), since there can be thousands of them and they are only
+  // needed to update offsets when saving.
+
+  const offset_t end = file->length();
+  ByteVector buffer;
+  offset_t bufferOffset = 0;
+  offset_t position = 0;
+  while(position + 8 <= end) {
+    auto atom = new MP4::Atom(position);
     atoms.append(atom);
-    if (atom->length == 0)
+    position = atom->read(file, buffer, bufferOffset, false);
+    if(atom->length == 0)
       break;
   }
 }
 
 MP4::Atoms::~Atoms() = default;
 
+void
+MP4::Atoms::readFragments(File *file)
+{
+  ByteVector buffer;
+  offset_t bufferOffset = 0;
+  for(const auto &atom : std::as_const(atoms)) {
+    if(atom->name == "moof" && atom->children.isEmpty())
+      atom->read(file, buffer, bufferOffset, true);
+  }
+}
+
 MP4::Atom *
 MP4::Atoms::find(const char *name1, const char *name2, const char *name3, const char *name4)
 {
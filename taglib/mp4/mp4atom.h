@@ -88,6 +88,11 @@ namespace TagLib {
       offset_t length;
       TagLib::ByteVector name;
       AtomList children;
+
+    private:
+      friend class Atoms;
+      Atom(offset_t offset);
+      offset_t read(File *file, ByteVector &buffer, offset_t &bufferOffset, bool readFragment);
     };
 
     //! Root-level atoms
@@ -100,6 +105,10 @@ namespace TagLib {
       Atoms &operator=(const Atoms &) = delete;
       Atom *find(const char *name1, const char *name2 = nullptr, const char *name3 = nullptr, const char *name4 = nullptr);
       AtomList path(const char *name1, const char *name2 = nullptr, const char *name3 = nullptr, const char *name4 = nullptr);
+      // The children of fragments ('moof') are not read when the atoms are
+      // created.  This reads them, which has to be done before the file is
+      // modified, since they are located using their original offsets.
+      void readFragments(File *file);
       AtomList atoms;
     };
   } // namespace MP4
@@ -33,10 +33,15 @@ using namespace TagLib;
 
 namespace
 {
+  // The fragments are not checked, so that their children do not have to be
+  // read when opening the file.
+
   bool checkValid(const MP4::AtomList &list)
   {
     return std::none_of(list.begin(), list.end(),
-      [](const auto &a) { return a->length == 0 || !checkValid(a->children); });
+      [](const auto &a) {
+        return a->length == 0 || (a->name != "moof" && !checkValid(a->children));
+      });
   }
 }  // namespace
 
@@ -53,11 +58,15 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool MP4::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 8, false));
+}
+
+bool MP4::File::isSupported(const ByteVector &data)
 {
   // An MP4 file has to have an "ftyp" box first.
 
-  const ByteVector id = Utils::readHeader(stream, 8, false);
-  return id.containsAt("ftyp", 4);
+  return (data.containsAt("ftyp", 4));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -46,7 +46,9 @@ namespace
       if(atom->name == "mdat")
         totalLength += length;
 
-      totalLength += calculateMdatLength(atom->children);
+      // Fragments do not contain any 'mdat' atoms.
+      if(atom->name != "moof")
+        totalLength += calculateMdatLength(atom->children);
     }
 
     return totalLength;
@@ -25,22 +25,321 @@
 
 #include "mp4tag.h"
 
+#include <algorithm>
 #include <array>
 #include <utility>
+#include <vector>
 
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tagutils.h"
 #include "id3v1genres.h"
 #include "mp4atom.h"
 
 using namespace TagLib;
 
+namespace
+{
+  // Chunk offset tables of long recordings can have millions of entries, so
+  // they are processed in blocks of this size instead of as a whole.
+
+  constexpr unsigned int chunkOffsetBlockSize = 64 * 1024;
+
+  // Calls func with each block of entries of the 'stco' or 'co64' table atom
+  // and the position of the block in the file, as long as func returns true.
+
+  template <typename T, typename Func>
+  void forEachChunkOffsetBlock(TagLib::File *file, const MP4::Atom *atom, Func func)
+  {
+    file->seek(atom->offset + 12);
+    const ByteVector countData = file->readBlock(4);
+    if(countData.size() != 4)
+      return;
+
+    offset_t remaining = std::min<offset_t>(
+      static_cast<offset_t>(countData.toUInt()) * sizeof(T), atom->length - 16);
+    offset_t position = atom->offset + 16;
+
+    while(remaining >= static_cast<offset_t>(sizeof(T))) {
+      const auto size = static_cast<size_t>(std::min<offset_t>(remaining, chunkOffsetBlockSize));
+      file->seek(position);
+      ByteVector block = file->readBlock(size - size % sizeof(T));
+      if(block.isEmpty() || !func(block, position))
+        return;
+
+      position += block.size();
+      remaining -= block.size();
+    }
+  }
+
+  template <typename T>
+  T readChunkOffset(const unsigned char *p)
+  {
+    T value = 0;
+    for(size_t j = 0; j < sizeof(T); ++j)
+      value = static_cast<T>((value << 8) | p[j]);
+    return value;
+  }
+
+  // Adds delta to every entry of a block of a 'stco' or 'co64' table which
+  // points past offset.  The block is patched in place so that it can be
+  // written back with a single call, instead of one write per chunk.
+  // Returns true if any of the entries was changed.
+
+  template <typename T>
+  bool updateChunkOffsets(ByteVector &entries, offset_t delta, offset_t offset)
+  {
+    const size_t count = entries.size() / sizeof(T);
+    auto p = reinterpret_cast<unsigned char *>(entries.data());
+
+    bool changed = false;
+    for(size_t i = 0; i < count; ++i, p += sizeof(T)) {
+      T value = readChunkOffset<T>(p);
+      if(static_cast<offset_t>(value) > offset) {
+        value = static_cast<T>(value + delta);
+        for(size_t j = sizeof(T); j > 0; --j) {
+          p[j - 1] = static_cast<unsigned char>(value & 0xff);
+          value >>= 8;
+        }
+        changed = true;
+      }
+    }
+
+    return changed;
+  }
+
+  template <typename T>
+  void updateChunkOffsetTable(TagLib::File *file, const MP4::Atom *atom,
+                              offset_t delta, offset_t offset)
+  {
+    forEachChunkOffsetBlock<T>(file, atom, [&](ByteVector &block, offset_t position) {
+      if(updateChunkOffsets<T>(block, delta, offset)) {
+        file->seek(position);
+        file->writeBlock(block);
+      }
+      return true;
+    });
+  }
+
+  // Returns true if adding delta to the entries of the 'stco' atom which point
+  // past offset would exceed the range of its 32-bit entries.
+
+  bool chunkOffsetsOverflow(TagLib::File *file, const MP4::Atom *atom,
+                            offset_t delta, offset_t offset)
+  {
+    bool overflow = false;
+    forEachChunkOffsetBlock<unsigned int>(file, atom, [&](const ByteVector &block, offset_t) {
+      auto p = reinterpret_cast<const unsigned char *>(block.data());
+      for(unsigned int i = 0; i < block.size() / 4; ++i, p += 4) {
+        const auto value = static_cast<offset_t>(readChunkOffset<unsigned int>(p));
+        if(value > offset && value + delta > 0xFFFFFFFF) {
+          overflow = true;
+          break;
+        }
+      }
+      return !overflow;
+    });
+    return overflow;
+  }
+
+  // Returns true if adding delta to the size of one of the atoms would exceed
+  // the range of its 32-bit size field.  Atoms with a 64-bit size can always
+  // grow.
+
+  bool sizesOverflow(TagLib::File *file, const MP4::AtomList &atoms, offset_t delta)
+  {
+    return std::any_of(atoms.begin(), atoms.end(), [&](const MP4::Atom *atom) {
+      file->seek(atom->offset);
+      const offset_t size = file->readBlock(4).toUInt();
+      return size != 1 && size + delta > 0xFFFFFFFF;
+    });
+  }
+
+  // Replaces the 'stco' atom by a 'co64' atom with the same entries and
+  // returns the number of bytes by which the atom has grown, or 0 if the atom
+  // or one of its parents would become too large.  The atom is grown once
+  // with zeros, which are written in blocks, and the entries are then widened
+  // in place, block by block from the end, so that no 32-bit entry is
+  // overwritten before it has been read.
+
+  offset_t convertToCo64(TagLib::File *file, MP4::Atom *atom, const MP4::AtomList &parents)
+  {
+    file->seek(atom->offset + 12);
+    const offset_t count = std::min<offset_t>(file->readBlock(4).toUInt(), (atom->length - 16) / 4);
+    const offset_t length = 16 + count * 8;
+    if(length > 0xFFFFFFFF || sizesOverflow(file, parents, length - atom->length)) {
+      debug("MP4: Chunk offset table too large to be converted to 64-bit");
+      return 0;
+    }
+
+    const offset_t tableEnd = atom->offset + 16 + count * 4;
+    file->insertZeros(count * 4, tableEnd, static_cast<size_t>(atom->offset + atom->length - tableEnd));
+
+    constexpr offset_t entriesPerBlock = chunkOffsetBlockSize / 4;
+    for(offset_t end = count; end > 0; ) {
+      const offset_t begin = std::max<offset_t>(end - entriesPerBlock, 0);
+      file->seek(atom->offset + 16 + begin * 4);
+      const ByteVector block = file->readBlock(static_cast<size_t>((end - begin) * 4));
+
+      ByteVector entries(block.size() * 2, '\0');
+      for(unsigned int i = 0; i < block.size() / 4; ++i)
+        std::copy(block.begin() + i * 4, block.begin() + i * 4 + 4, entries.begin() + i * 8 + 4);
+
+      file->seek(atom->offset + 16 + begin * 8);
+      file->writeBlock(entries);
+      end = begin;
+    }
+
+    file->seek(atom->offset);
+    file->writeBlock(ByteVector::fromUInt(static_cast<unsigned int>(length)) + ByteVector("co64"));
+    file->seek(atom->offset + 12);
+    file->writeBlock(ByteVector::fromUInt(static_cast<unsigned int>(count)));
+
+    const offset_t growth = length - atom->length;
+    atom->name = "co64";
+    atom->length = length;
+    return growth;
+  }
+
+  // Adds delta to the offsets of the atoms located past offset, including
+  // their children.
+
+  void updateAtomOffsets(const MP4::AtomList &atoms, offset_t delta, offset_t offset)
+  {
+    for(const auto &atom : atoms) {
+      if(atom->offset > offset)
+        atom->offset += delta;
+      updateAtomOffsets(atom->children, delta, offset);
+    }
+  }
+
+  // Collects the atoms from root down to the parent of atom in parents.
+
+  bool findParents(MP4::Atom *root, const MP4::Atom *atom, MP4::AtomList &parents)
+  {
+    parents.append(root);
+    for(const auto &child : std::as_const(root->children)) {
+      if(child == atom || findParents(child, atom, parents))
+        return true;
+    }
+    parents.erase(std::prev(parents.end()));
+    return false;
+  }
+
+  // Returns true if 'moov' can be written to the end of the file and that is
+  // cheaper than moving the data after it.  Fragmented files are excluded,
+  // since the fragments have to follow 'moov', as well as files whose last
+  // atom extends to the end of the file.
+
+  bool canRelocateMoov(TagLib::File *file, MP4::Atoms *atoms, const MP4::Atom *moov)
+  {
+    if(atoms->atoms.isEmpty() || atoms->atoms.back() == moov)
+      return false;
+
+    if(std::any_of(atoms->atoms.begin(), atoms->atoms.end(),
+                   [](const MP4::Atom *atom) { return atom->name == "moof"; }))
+      return false;
+
+    const MP4::Atom *last = atoms->atoms.back();
+    const offset_t fileLength = file->length();
+    if(last->length == 0 || last->offset + last->length != fileLength)
+      return false;
+
+    file->seek(last->offset);
+    if(file->readBlock(4).toUInt() == 0)
+      return false;
+
+    // A 'moov' of more than 4 GiB is left to ShiftData, which handles 64-bit
+    // atom sizes.
+
+    if(moov->length > 0xFFFFFFFF)
+      return false;
+
+    return moov->length < fileLength - (moov->offset + moov->length);
+  }
+
+  // Appends length bytes at from to the end of the file, in blocks.
+
+  void appendCopy(TagLib::File *file, offset_t from, offset_t length)
+  {
+    constexpr offset_t copyBlockSize = 64 * 1024;
+
+    offset_t to = file->length();
+    for(offset_t done = 0; done < length; ) {
+      file->seek(from + done);
+      const ByteVector block =
+        file->readBlock(static_cast<size_t>(std::min(length - done, copyBlockSize)));
+      if(block.isEmpty())
+        break;
+
+      file->seek(to);
+      file->writeBlock(block);
+      to += block.size();
+      done += block.size();
+    }
+  }
+
+  // Writes a copy of 'moov' to the end of the file, in which length bytes at
+  // offset are replaced by data and the lengths of the parents are adjusted,
+  // and turns the old 'moov' into a 'free' atom.  The media data is not
+  // moved, so the chunk offsets stay valid.
+
+  void relocateMoov(TagLib::File *file, MP4::Atoms *atoms, const MP4::AtomList &parents,
+                    const ByteVector &data, offset_t offset, offset_t length)
+  {
+    MP4::Atom *moov = parents.front();
+    const offset_t delta = data.size() - length;
+    const offset_t newOffset = file->length();
+
+    // Copy 'moov' with data in place of the replaced bytes, without reading
+    // the whole atom, which may contain large sample tables.
+
+    appendCopy(file, moov->offset, offset - moov->offset);
+    file->seek(file->length());
+    file->writeBlock(data);
+    appendCopy(file, offset + length, moov->offset + moov->length - (offset + length));
+
+    // Adjust the sizes of the parents in the copy.  They all start before
+    // offset, so their position relative to 'moov' is unchanged.
+
+    for(const auto &atom : parents) {
+      const offset_t pos = newOffset + (atom->offset - moov->offset);
+      file->seek(pos);
+      const offset_t size = file->readBlock(4).toUInt();
+      if(size == 1) {
+        file->seek(pos + 8);
+        const long long longSize = file->readBlock(8).toLongLong();
+        file->seek(pos + 8);
+        file->writeBlock(ByteVector::fromLongLong(longSize + delta));
+      }
+      else {
+        file->seek(pos);
+        file->writeBlock(ByteVector::fromUInt(static_cast<unsigned int>(size + delta)));
+      }
+    }
+
+    file->seek(moov->offset + 4);
+    file->writeBlock("free");
+
+    // Update the atom tree, this invalidates the atoms in parents.
+
+    moov->name = "free";
+    moov->children.clear();
+
+    file->seek(newOffset);
+    atoms->atoms.append(new MP4::Atom(file));
+  }
+}  // namespace
+
 class MP4::Tag::TagPrivate
 {
 public:
   TagLib::File *file { nullptr };
   Atoms *atoms { nullptr };
   ItemMap items;
+  unsigned int paddingSize { 0 };
+  bool moovRelocationEnabled { false };
+  SaveStrategy saveStrategy { NotSaved };
 };
 
 MP4::Tag::Tag() :
@@ -61,6 +360,11 @@ MP4::Tag::Tag(TagLib::File *file, MP4::Atoms *atoms) :
   }
 
   for(const auto &atom : std::as_const(ilst->children)) {
+    if(atom->length > 0xFFFFFFFF) {
+      // Items are read as a whole, which is limited by the size of ByteVector.
+      debug("MP4: Skipping item of more than 4 GiB");
+      continue;
+    }
     file->seek(atom->offset + 8);
     if(atom->name == "----") {
       parseFreeForm(atom);
@@ -327,7 +631,7 @@ ByteVector
 MP4::Tag::padIlst(const ByteVector &data, int length) const
 {
   if(length == -1) {
-    length = ((data.size() + 1023) & ~1023) - data.size();
+    length = ((data.size() + d->paddingSize + 1023) & ~1023) - data.size();
   }
   return renderAtom("free", ByteVector(length, '\1'));
 }
@@ -525,25 +829,24 @@ MP4::Tag::save()
   }
   data = renderAtom("ilst", data);
 
+  d->saveStrategy = NotSaved;
+
   AtomList path = d->atoms->path("moov", "udta", "meta", "ilst");
   if(path.size() == 4) {
-    saveExisting(data, path);
-  }
-  else {
-    saveNew(data);
+    return saveExisting(data, path);
   }
-
-  return true;
+  return saveNew(data);
 }
 
 bool
 MP4::Tag::strip()
 {
   d->items.clear();
+  d->saveStrategy = NotSaved;
 
   AtomList path = d->atoms->path("moov", "udta", "meta", "ilst");
   if(path.size() == 4) {
-    saveExisting(ByteVector(), path);
+    return saveExisting(ByteVector(), path);
   }
 
   return true;
@@ -560,7 +863,7 @@ MP4::Tag::updateParents(const AtomList &path, offset_t delta, int ignore)
 
   for(auto it = path.begin(); it != itEnd; ++it) {
     d->file->seek((*it)->offset);
-    long size = d->file->readBlock(4).toUInt();
+    const offset_t size = d->file->readBlock(4).toUInt();
     // 64-bit
     if (size == 1) {
       d->file->seek(4, File::Current); // Skip name
@@ -570,82 +873,104 @@ MP4::Tag::updateParents(const AtomList &path, offset_t delta, int ignore)
       d->file->writeBlock(ByteVector::fromLongLong(longSize + delta));
     }
     // 32-bit
-    else {
+    else if(size + delta <= 0xFFFFFFFF) {
       d->file->seek((*it)->offset);
       d->file->writeBlock(ByteVector::fromUInt(static_cast<unsigned int>(size + delta)));
     }
+    else {
+      debug("MP4: Atom size exceeds the range of its 32-bit length");
+    }
   }
 }
 
-void
+bool
 MP4::Tag::updateOffsets(offset_t delta, offset_t offset)
 {
+  // The fragments must have been read before the file was modified.
+  updateAtomOffsets(d->atoms->atoms, delta, offset);
+
+  MP4::AtomList stco;
+  MP4::AtomList co64;
   MP4::Atom *moov = d->atoms->find("moov");
   if(moov) {
-    const MP4::AtomList stco = moov->findall("stco", true);
-    for(const auto &atom : stco) {
-      if(atom->offset > offset) {
-        atom->offset += delta;
-      }
-      d->file->seek(atom->offset + 12);
-      ByteVector data = d->file->readBlock(atom->length - 12);
-      unsigned int count = data.toUInt();
-      d->file->seek(atom->offset + 16);
-      unsigned int pos = 4;
-      while(count--) {
-        auto o = static_cast<offset_t>(data.toUInt(pos));
-        if(o > offset) {
-          o += delta;
-        }
-        d->file->writeBlock(ByteVector::fromUInt(static_cast<unsigned int>(o)));
-        pos += 4;
-      }
-    }
+    stco = moov->findall("stco", true);
+    co64 = moov->findall("co64", true);
+  }
 
-    const MP4::AtomList co64 = moov->findall("co64", true);
-    for(const auto &atom : co64) {
-      if(atom->offset > offset) {
-        atom->offset += delta;
-      }
-      d->file->seek(atom->offset + 12);
-      ByteVector data = d->file->readBlock(atom->length - 12);
-      unsigned int count = data.toUInt();
-      d->file->seek(atom->offset + 16);
-      unsigned int pos = 4;
-      while(count--) {
-        long long o = data.toLongLong(pos);
-        if(o > offset) {
-          o += delta;
-        }
-        d->file->writeBlock(ByteVector::fromLongLong(o));
-        pos += 8;
+  // Entries which would be pushed past 4 GiB need 64-bit tables.  All the
+  // tables are converted then, starting with the last one, so that each
+  // conversion only moves the atoms which have not been converted yet.
+
+  std::vector<std::pair<offset_t, offset_t>> conversions;
+  bool converted = true;
+  if(delta > 0 && std::any_of(stco.begin(), stco.end(), [&](const MP4::Atom *atom) {
+       return chunkOffsetsOverflow(d->file, atom, delta, offset);
+     })) {
+    std::vector<MP4::Atom *> tables(stco.begin(), stco.end());
+    std::sort(tables.begin(), tables.end(), [](const MP4::Atom *a, const MP4::Atom *b) {
+      return a->offset > b->offset;
+    });
+
+    for(const auto &atom : tables) {
+      AtomList parents;
+      findParents(moov, atom, parents);
+
+      const offset_t growth = convertToCo64(d->file, atom, parents);
+      if(growth == 0) {
+        converted = false;
+        continue;
       }
+
+      updateParents(parents, growth);
+      updateAtomOffsets(d->atoms->atoms, growth, atom->offset);
+      conversions.emplace_back(atom->offset, growth);
     }
+
+    MP4::AtomList remaining;
+    for(const auto &atom : std::as_const(stco))
+      (atom->name == "co64" ? co64 : remaining).append(atom);
+    stco = remaining;
   }
 
-  MP4::Atom *moof = d->atoms->find("moof");
-  if(moof) {
-    const MP4::AtomList tfhd = moof->findall("tfhd", true);
-    for(const auto &atom : tfhd) {
-      if(atom->offset > offset) {
-        atom->offset += delta;
-      }
+  MP4::AtomList tfhd;
+  for(const auto &moof : std::as_const(d->atoms->atoms)) {
+    if(moof->name == "moof")
+      tfhd.append(moof->findall("tfhd", true));
+  }
+
+  // The conversions took place after the data had been shifted by delta, and
+  // the later ones did not move the earlier ones, so the shifts can be
+  // applied to the entries one after another.
+
+  conversions.insert(conversions.begin(), { offset, delta });
+  for(const auto &[shiftOffset, shift] : conversions) {
+    for(const auto &atom : std::as_const(stco))
+      updateChunkOffsetTable<unsigned int>(d->file, atom, shift, shiftOffset);
+
+    for(const auto &atom : std::as_const(co64))
+      updateChunkOffsetTable<unsigned long long>(d->file, atom, shift, shiftOffset);
+
+    for(const auto &atom : std::as_const(tfhd)) {
       d->file->seek(atom->offset + 9);
       ByteVector data = d->file->readBlock(atom->length - 9);
       const unsigned int flags = data.toUInt(0, 3, true);
       if(flags & 1) {
         long long o = data.toLongLong(7U);
-        if(o > offset) {
-          o += delta;
+        if(o > shiftOffset) {
+          o += shift;
         }
         d->file->seek(atom->offset + 16);
         d->file->writeBlock(ByteVector::fromLongLong(o));
       }
     }
   }
+
+  // The entries of the tables which could not be converted are wrong now.
+
+  return converted;
 }
 
-void
+bool
 MP4::Tag::saveNew(ByteVector data)
 {
   data = renderAtom("meta", ByteVector(4, '\0') +
@@ -660,18 +985,36 @@ MP4::Tag::saveNew(ByteVector data)
   }
 
   offset_t offset = path.back()->offset + 8;
+
+  if(sizesOverflow(d->file, path, data.size())) {
+    debug("MP4::Tag::save() -- The size of a parent atom would exceed 4 GiB.");
+    return false;
+  }
+
+  if(d->moovRelocationEnabled && canRelocateMoov(d->file, d->atoms, path.front())) {
+    relocateMoov(d->file, d->atoms, path, data, offset, 0);
+    d->saveStrategy = RelocateMoov;
+    return true;
+  }
+
+  d->atoms->readFragments(d->file);
   d->file->insert(data, offset, 0);
+  d->saveStrategy = ShiftData;
 
   updateParents(path, data.size());
-  updateOffsets(data.size(), offset);
+  const bool updated = updateOffsets(data.size(), offset);
 
-  // Insert the newly created atoms into the tree to keep it up-to-date.
+  // Insert the newly created atoms into the tree to keep it up-to-date.  The
+  // offset is taken from the tree, since converting the chunk offset tables
+  // may have moved it.
 
-  d->file->seek(offset);
+  d->file->seek(path.back()->offset + 8);
   path.back()->children.prepend(new Atom(d->file));
+
+  return updated;
 }
 
-void
+bool
 MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
 {
   auto it = path.end();
@@ -712,12 +1055,32 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
       delta = 0;
     }
 
-    d->file->insert(data, offset, length);
+    if(delta == 0) {
+      d->file->insert(data, offset, length);
+      d->saveStrategy = InPlace;
+      return true;
+    }
+
+    AtomList parents = path;
+    parents.erase(std::prev(parents.end()));
+
+    if(sizesOverflow(d->file, parents, delta)) {
+      debug("MP4::Tag::save() -- The size of a parent atom would exceed 4 GiB.");
+      return false;
+    }
 
-    if(delta) {
-      updateParents(path, delta, 1);
-      updateOffsets(delta, offset);
+    if(d->moovRelocationEnabled && canRelocateMoov(d->file, d->atoms, path.front())) {
+      relocateMoov(d->file, d->atoms, parents, data, offset, length);
+      d->saveStrategy = RelocateMoov;
+      return true;
     }
+
+    d->atoms->readFragments(d->file);
+    d->file->insert(data, offset, length);
+    d->saveStrategy = ShiftData;
+
+    updateParents(path, delta, 1);
+    return updateOffsets(delta, offset);
   }
   else {
     // Strip meta if data is empty, only the case when called from strip().
@@ -728,15 +1091,49 @@ MP4::Tag::saveExisting(ByteVector data, const AtomList &path)
       offset = meta->offset;
       delta = - meta->length;
       udtaChildren.erase(metaIt);
+      d->atoms->readFragments(d->file);
       d->file->removeBlock(meta->offset, meta->length);
+      d->saveStrategy = ShiftData;
       delete meta;
 
       if(delta) {
         updateParents(path, delta, 2);
-        updateOffsets(delta, offset);
+        return updateOffsets(delta, offset);
       }
     }
   }
+
+  return true;
+}
+
+void
+MP4::Tag::setPaddingSize(unsigned int size)
+{
+  d->paddingSize = size;
+}
+
+unsigned int
+MP4::Tag::paddingSize() const
+{
+  return d->paddingSize;
+}
+
+void
+MP4::Tag::setMoovRelocationEnabled(bool enabled)
+{
+  d->moovRelocationEnabled = enabled;
+}
+
+bool
+MP4::Tag::isMoovRelocationEnabled() const
+{
+  return d->moovRelocationEnabled;
+}
+
+MP4::Tag::SaveStrategy
+MP4::Tag::saveStrategy() const
+{
+  return d->saveStrategy;
 }
 
 String
@@ -1013,24 +1410,25 @@ void MP4::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap MP4::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, String> reverseKeyMap;
-  if(reverseKeyMap.isEmpty()) {
+  static const Map<String, String> reverseKeyMap = [] {
+    Map<String, String> map;
     for(const auto &[k, t] : keyTranslation) {
-      reverseKeyMap[t] = k;
+      map[t] = k;
     }
-  }
+    return map;
+  }();
 
   const PropertyMap origProps = properties();
   for(const auto &[prop, _] : origProps) {
     if(!props.contains(prop) || props[prop].isEmpty()) {
-      d->items.erase(reverseKeyMap[prop]);
+      d->items.erase(reverseKeyMap.value(prop));
     }
   }
 
   PropertyMap ignoredProps;
   for(const auto &[prop, val] : props) {
     if(reverseKeyMap.contains(prop)) {
-      String name = reverseKeyMap[prop];
+      String name = reverseKeyMap.value(prop);
       if((prop == "TRACKNUMBER" || prop == "DISCNUMBER") && !val.isEmpty()) {
         StringList parts = StringList::split(val.front(), "/");
         if(!parts.isEmpty()) {
@@ -1069,7 +1467,7 @@ PropertyMap MP4::Tag::setProperties(const PropertyMap &props)
 void MP4::Tag::addItem(const String &name, const Item &value)
 {
   if(!d->items.contains(name)) {
-    d->items.insert(name, value);
+    d->items.insert(Utils::internKey(name), value);
   }
   else {
     debug("MP4: Ignoring duplicate atom \"" + name + "\"");
@@ -98,6 +98,63 @@ namespace TagLib {
          */
         bool strip();
 
+        /*!
+         * The ways in which save() and strip() can update the file.
+         *
+         * \see saveStrategy()
+         */
+        enum SaveStrategy {
+          //! Nothing has been written to the file.
+          NotSaved,
+          //! The item list was written into the space it occupied before,
+          //! including adjacent 'free' atoms.  No other data was moved.
+          InPlace,
+          //! The data after the item list was moved and the chunk offsets
+          //! were updated.
+          ShiftData,
+          //! The 'moov' atom was written to the end of the file and the old
+          //! one was turned into a 'free' atom.  The media data was not
+          //! moved.
+          RelocateMoov
+        };
+
+        /*!
+         * Sets the minimum free space in bytes which is reserved after the
+         * item list whenever it has to grow, so that later changes can be
+         * saved in place.  The free space is rounded up so that it ends on a
+         * 1 KiB boundary.  The default is 0.
+         */
+        void setPaddingSize(unsigned int size);
+
+        /*!
+         * Returns the minimum free space reserved after the item list.
+         *
+         * \see setPaddingSize()
+         */
+        unsigned int paddingSize() const;
+
+        /*!
+         * If \a enabled is true, save() writes the 'moov' atom to the end of
+         * the file when the item list does not fit and 'moov' is smaller than
+         * the data after it, instead of moving that data.  This is disabled
+         * by default, since files with 'moov' before the media data can be
+         * played while they are downloaded.
+         */
+        void setMoovRelocationEnabled(bool enabled);
+
+        /*!
+         * Returns true if save() may move the 'moov' atom to the end of the
+         * file.
+         *
+         * \see setMoovRelocationEnabled()
+         */
+        bool isMoovRelocationEnabled() const;
+
+        /*!
+         * Returns how the last call to save() or strip() updated the file.
+         */
+        SaveStrategy saveStrategy() const;
+
         PropertyMap properties() const override;
         void removeUnsupportedProperties(const StringList &props) override;
         PropertyMap setProperties(const PropertyMap &props) override;
@@ -142,10 +199,10 @@ namespace TagLib {
         ByteVector renderCovr(const ByteVector &name, const Item &item) const;
 
         void updateParents(const AtomList &path, offset_t delta, int ignore = 0);
-        void updateOffsets(offset_t delta, offset_t offset);
+        bool updateOffsets(offset_t delta, offset_t offset);
 
-        void saveNew(ByteVector data);
-        void saveExisting(ByteVector data, const AtomList &path);
+        bool saveNew(ByteVector data);
+        bool saveExisting(ByteVector data, const AtomList &path);
 
         void addItem(const String &name, const Item &value);
 
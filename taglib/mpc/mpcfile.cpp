@@ -63,32 +63,36 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool MPC::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 4, false));
+}
+
+bool MPC::File::isSupported(const ByteVector &data)
 {
   // A newer MPC file has to start with "MPCK" or "MP+", but older files don't
   // have keys to do a quick check.
 
-  const ByteVector id = Utils::readHeader(stream, 4, false);
-  return (id == "MPCK" || id.startsWith("MP+"));
+  return (data.startsWith("MPCK") || data.startsWith("MP+"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MPC::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+MPC::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-MPC::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+MPC::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPC::File::~File() = default;
@@ -248,7 +252,7 @@ bool MPC::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPC::File::read(bool readProperties)
+void MPC::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -282,7 +286,7 @@ void MPC::File::read(bool readProperties)
 
   // Look for MPC metadata
 
-  if(readProperties) {
+  if(readProperties && propertiesStyle != Properties::HeadOnly) {
 
     offset_t streamLength;
 
@@ -85,7 +85,8 @@ namespace TagLib {
        * Constructs an MPC file from \a file.  If \a readProperties is true the
        * file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -97,7 +98,8 @@ namespace TagLib {
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -218,8 +220,15 @@ namespace TagLib {
        */
       static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns whether or not a file starting with \a data can be opened as
+       * an MPC file.  This does the same check as isSupported(IOStream *) on
+       * data which has already been read.
+       */
+      static bool isSupported(const ByteVector &data);
+
     private:
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
 
       class FilePrivate;
       std::unique_ptr<FilePrivate> d;
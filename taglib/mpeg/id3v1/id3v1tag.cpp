@@ -25,6 +25,8 @@
 
 #include "id3v1tag.h"
 
+#include <atomic>
+
 #include "tdebug.h"
 #include "tfile.h"
 #include "id3v1genres.h"
@@ -35,7 +37,7 @@ using namespace ID3v1;
 namespace
 {
   const ID3v1::StringHandler defaultStringHandler;
-  const ID3v1::StringHandler *stringHandler = &defaultStringHandler;
+  std::atomic<const ID3v1::StringHandler *> stringHandler = &defaultStringHandler;
 } // namespace
 
 class ID3v1::Tag::TagPrivate
@@ -99,14 +101,15 @@ ID3v1::Tag::~Tag() = default;
 
 ByteVector ID3v1::Tag::render() const
 {
+  const StringHandler *handler = stringHandler;
   ByteVector data;
 
   data.append(fileIdentifier());
-  data.append(stringHandler->render(d->title).resize(30));
-  data.append(stringHandler->render(d->artist).resize(30));
-  data.append(stringHandler->render(d->album).resize(30));
-  data.append(stringHandler->render(d->year).resize(4));
-  data.append(stringHandler->render(d->comment).resize(28));
+  data.append(handler->render(d->title).resize(30));
+  data.append(handler->render(d->artist).resize(30));
+  data.append(handler->render(d->album).resize(30));
+  data.append(handler->render(d->year).resize(4));
+  data.append(handler->render(d->comment).resize(28));
   data.append(static_cast<char>(0));
   data.append(static_cast<char>(d->track));
   data.append(static_cast<char>(d->genre));
@@ -228,18 +231,19 @@ void ID3v1::Tag::read()
 
 void ID3v1::Tag::parse(const ByteVector &data)
 {
+  const StringHandler *handler = stringHandler;
   int offset = 3;
 
-  d->title = stringHandler->parse(data.mid(offset, 30));
+  d->title = handler->parse(data.mid(offset, 30));
   offset += 30;
 
-  d->artist = stringHandler->parse(data.mid(offset, 30));
+  d->artist = handler->parse(data.mid(offset, 30));
   offset += 30;
 
-  d->album = stringHandler->parse(data.mid(offset, 30));
+  d->album = handler->parse(data.mid(offset, 30));
   offset += 30;
 
-  d->year = stringHandler->parse(data.mid(offset, 4));
+  d->year = handler->parse(data.mid(offset, 4));
   offset += 4;
 
   // Check for ID3v1.1 -- Note that ID3v1 *does not* support "track zero" -- this
@@ -250,7 +254,7 @@ void ID3v1::Tag::parse(const ByteVector &data)
   if(data[offset + 28] == 0 && data[offset + 29] != 0) {
     // ID3v1.1 detected
 
-    d->comment = stringHandler->parse(data.mid(offset, 28));
+    d->comment = handler->parse(data.mid(offset, 28));
     d->track   = static_cast<unsigned char>(data[offset + 29]);
   }
   else
@@ -69,7 +69,7 @@ TextIdentificationFrame *TextIdentificationFrame::createTIPLFrame(const Property
   auto frame = new TextIdentificationFrame("TIPL");
   StringList l;
   for(const auto &[person, list] : properties) {
-    const String role = involvedPeopleMap()[person];
+    const String role = involvedPeopleMap().value(person);
     if(role.isEmpty()) // should not happen
       continue;
     l.append(role);
@@ -139,11 +139,12 @@ namespace
 
 const KeyConversionMap &TextIdentificationFrame::involvedPeopleMap() // static
 {
-  static KeyConversionMap m;
-  if(m.isEmpty()) {
+  static const KeyConversionMap m = [] {
+    KeyConversionMap map;
     for(const auto &[o, t] : involvedPeople)
-      m.insert(t, o);
-  }
+      map.insert(t, o);
+    return map;
+  }();
   return m;
 }
 
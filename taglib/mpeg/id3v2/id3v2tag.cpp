@@ -26,6 +26,7 @@
 #include "id3v2tag.h"
 
 #include <algorithm>
+#include <atomic>
 #include <utility>
 
 #include "tdebug.h"
@@ -49,7 +50,7 @@ using namespace ID3v2;
 namespace
 {
   const ID3v2::Latin1StringHandler defaultStringHandler;
-  const ID3v2::Latin1StringHandler *stringHandler = &defaultStringHandler;
+  std::atomic<const ID3v2::Latin1StringHandler *> stringHandler = &defaultStringHandler;
 
   const long MinPaddingSize = 1024;
   const long MaxPaddingSize = 1024 * 1024;
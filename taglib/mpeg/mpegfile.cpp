@@ -41,6 +41,33 @@ using namespace TagLib;
 namespace
 {
   enum { ID3v2Index = 0, APEIndex = 1, ID3v1Index = 2 };
+
+  // Returns the length of a valid MPEG frame starting at \a offset of
+  // \a buffer, which has been read from \a bufferOffset of \a file, or 0 if
+  // there is no valid frame.  The header of the following frame is checked
+  // in the buffer too, the file is only read if it lies beyond the buffer.
+
+  int validFrameLength(File *file, const ByteVector &buffer, unsigned int offset,
+                       offset_t bufferOffset)
+  {
+    if(offset + 4 > buffer.size() || !MPEG::isFrameSync(buffer, offset))
+      return 0;
+
+    const MPEG::Header header(buffer.mid(offset, 4));
+    if(!header.isValid())
+      return 0;
+
+    const unsigned int nextOffset = offset + header.frameLength();
+    if(nextOffset + 4 <= buffer.size()) {
+      if(!MPEG::isSameStream(buffer, offset, buffer, nextOffset))
+        return 0;
+    }
+    else if(!MPEG::Header(file, bufferOffset + offset, true).isValid()) {
+      return 0;
+    }
+
+    return header.frameLength();
+  }
 } // namespace
 
 class MPEG::File::FilePrivate
@@ -60,6 +87,7 @@ public:
   long APEOriginalSize { 0 };
 
   offset_t ID3v1Location { -1 };
+  bool headOnly { false };
 
   TagUnion tag;
 
@@ -105,12 +133,9 @@ bool MPEG::File::isSupported(IOStream *stream)
   AdapterFile file(stream);
 
   for(unsigned int i = 0; i < buffer.size() - 1; ++i) {
-    if(isFrameSync(buffer, i)) {
-      const Header header(&file, headerOffset + i, true);
-      if(header.isValid()) {
-        stream->seek(originalPosition);
-        return true;
-      }
+    if(validFrameLength(&file, buffer, i, headerOffset) > 0) {
+      stream->seek(originalPosition);
+      return true;
     }
   }
 
@@ -122,30 +147,30 @@ bool MPEG::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+MPEG::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPEG::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPEG::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                 bool readProperties, Properties::ReadStyle) :
+                 bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 MPEG::File::~File() = default;
@@ -192,6 +217,11 @@ bool MPEG::File::save(int tags, StripTags strip, ID3v2::Version version, Duplica
     return false;
   }
 
+  if(d->headOnly) {
+    debug("MPEG::File::save() -- Cannot save a file opened with HeadOnly.");
+    return false;
+  }
+
   // Create the tags if we've been asked to.
 
   if(duplicate == Duplicate) {
@@ -206,6 +236,11 @@ bool MPEG::File::save(int tags, StripTags strip, ID3v2::Version version, Duplica
       Tag::duplicate(ID3v2Tag(), ID3v1Tag(true), false);
   }
 
+  // Collect all the changes and apply them at once, so that the audio data is
+  // moved only once.
+
+  beginEdit();
+
   // Remove all the tags not going to be saved.
 
   if(strip == StripOthers)
@@ -245,15 +280,11 @@ bool MPEG::File::save(int tags, StripTags strip, ID3v2::Version version, Duplica
 
       // ID3v1 tag is not empty. Update the old one or create a new one.
 
-      if(d->ID3v1Location >= 0) {
-        seek(d->ID3v1Location);
-      }
-      else {
-        seek(0, End);
-        d->ID3v1Location = tell();
-      }
+      if(d->ID3v1Location < 0)
+        d->ID3v1Location = length();
 
-      writeBlock(ID3v1Tag()->render());
+      const ByteVector data = ID3v1Tag()->render();
+      insert(data, d->ID3v1Location, data.size());
     }
     else {
 
@@ -292,6 +323,8 @@ bool MPEG::File::save(int tags, StripTags strip, ID3v2::Version version, Duplica
     }
   }
 
+  commitEdit();
+
   return true;
 }
 
@@ -360,47 +393,39 @@ bool MPEG::File::strip(int tags, bool freeMemory)
 
 offset_t MPEG::File::nextFrameOffset(offset_t position)
 {
-  ByteVector frameSyncBytes(2, '\0');
+  // Consecutive blocks overlap by three bytes, so that a frame header on the
+  // boundary of two blocks is completely in the second one.
 
   while(true) {
     seek(position);
     const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
+    if(buffer.size() < 4)
       return -1;
 
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i - 1, true);
-        if(header.isValid())
-          return position + i - 1;
-      }
+    for(unsigned int i = 0; i < buffer.size() - 3; ++i) {
+      if(validFrameLength(this, buffer, i, position) > 0)
+        return position + i;
     }
 
-    position += bufferSize();
+    position += buffer.size() - 3;
   }
 }
 
 offset_t MPEG::File::previousFrameOffset(offset_t position)
 {
-  ByteVector frameSyncBytes(2, '\0');
-
   while(position > 0) {
     const offset_t bufferLength = std::min<offset_t>(position, bufferSize());
     position -= bufferLength;
 
+    // Read three more bytes to have the whole header of a frame starting at
+    // the end of the block.
+
     seek(position);
-    const ByteVector buffer = readBlock(bufferLength);
+    const ByteVector buffer = readBlock(bufferLength + 3);
 
-    for(int i = buffer.size() - 1; i >= 0; --i) {
-      frameSyncBytes[1] = frameSyncBytes[0];
-      frameSyncBytes[0] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i, true);
-        if(header.isValid())
-          return position + i + header.frameLength();
-      }
+    for(int i = static_cast<int>(bufferLength) - 1; i >= 0; --i) {
+      if(const int frameLength = validFrameLength(this, buffer, i, position))
+        return position + i + frameLength;
     }
   }
 
@@ -450,7 +475,7 @@ bool MPEG::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::File::read(bool readProperties)
+void MPEG::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -461,16 +486,18 @@ void MPEG::File::read(bool readProperties)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
-  // Look for an ID3v1 tag
+  // Look for an ID3v1 tag.  With HeadOnly, the end of the file is only read
+  // if there is no ID3v2 tag at the beginning.
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->headOnly = (propertiesStyle == Properties::HeadOnly && d->ID3v2Location >= 0);
+  d->ID3v1Location = d->headOnly ? -1 : Utils::findID3v1(this);
 
   if(d->ID3v1Location >= 0)
     d->tag.set(ID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
 
   // Look for an APE tag
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = d->headOnly ? -1 : Utils::findAPE(this, d->ID3v1Location);
 
   if(d->APELocation >= 0) {
     d->tag.set(APEIndex, new APE::Tag(this, d->APELocation));
@@ -478,8 +505,8 @@ void MPEG::File::read(bool readProperties)
     d->APELocation = d->APELocation + APE::Footer::size() - d->APEOriginalSize;
   }
 
-  if(readProperties)
-    d->properties = std::make_unique<Properties>(this);
+  if(readProperties && propertiesStyle != Properties::HeadOnly)
+    d->properties = std::make_unique<Properties>(this, propertiesStyle);
 
   // Make sure that we have our default tag types available.
 
@@ -321,7 +321,7 @@ namespace TagLib {
       static bool isSupported(IOStream *stream);
 
     private:
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       offset_t findID3v2();
 
       class FilePrivate;
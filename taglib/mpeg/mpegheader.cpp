@@ -61,6 +61,12 @@ MPEG::Header::Header(File *file, offset_t offset, bool checkLength) :
   parse(file, offset, checkLength);
 }
 
+MPEG::Header::Header(const ByteVector &data) :
+  d(std::make_shared<HeaderPrivate>())
+{
+  d->isValid = parse(data);
+}
+
 MPEG::Header::Header(const Header &) = default;
 MPEG::Header::~Header() = default;
 
@@ -142,16 +148,45 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   file->seek(offset);
   const ByteVector data = file->readBlock(4);
 
+  if(!parse(data))
+    return;
+
+  if(checkLength) {
+
+    // Check if the frame length has been calculated correctly, or the next frame
+    // header is right next to the end of this frame.
+
+    // The MPEG versions, layers and sample rates of the two frames should be
+    // consistent. Otherwise, we assume that either or both of the frames are
+    // broken.
+
+    file->seek(offset + d->frameLength);
+    const ByteVector nextData = file->readBlock(4);
+
+    if(nextData.size() < 4)
+      return;
+
+    if(!isSameStream(data, 0, nextData, 0))
+      return;
+  }
+
+  // Now that we're done parsing, set this to be a valid frame.
+
+  d->isValid = true;
+}
+
+bool MPEG::Header::parse(const ByteVector &data)
+{
   if(data.size() < 4) {
     debug("MPEG::Header::parse() -- data is too short for an MPEG frame header.");
-    return;
+    return false;
   }
 
   // Check for the MPEG synch bytes.
 
   if(!isFrameSync(data)) {
     debug("MPEG::Header::parse() -- MPEG header did not match MPEG synch.");
-    return;
+    return false;
   }
 
   // Set the MPEG version
@@ -165,7 +200,7 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   else if(versionBits == 3)
     d->version = Version1;
   else
-    return;
+    return false;
 
   // Set the MPEG layer
 
@@ -178,27 +213,12 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   else if(layerBits == 3)
     d->layer = 1;
   else
-    return;
+    return false;
 
   d->protectionEnabled = (static_cast<unsigned char>(data[1] & 0x01) == 0);
 
   // Set the bitrate
 
-  static constexpr std::array bitrates {
-    std::array {
-      // Version 1
-      std::array { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }, // layer 1
-      std::array { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },    // layer 2
-      std::array { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 }      // layer 3
-    },
-    std::array {
-      // Version 2 or 2.5
-      std::array { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }, // layer 1
-      std::array { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },      // layer 2
-      std::array { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 }       // layer 3
-    },
-  };
-
   const int versionIndex = (d->version == Version1) ? 0 : 1;
   const int layerIndex   = (d->layer > 0) ? d->layer - 1 : 0;
 
@@ -207,10 +227,10 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
 
   const int bitrateIndex = (static_cast<unsigned char>(data[2]) >> 4) & 0x0F;
 
-  d->bitrate = bitrates[versionIndex][layerIndex][bitrateIndex];
+  d->bitrate = frameBitrate(d->version == Version1, d->layer, bitrateIndex);
 
   if(d->bitrate == 0)
-    return;
+    return false;
 
   // Set the sample rate
 
@@ -227,7 +247,7 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   d->sampleRate = sampleRates[d->version][samplerateIndex];
 
   if(d->sampleRate == 0) {
-    return;
+    return false;
   }
 
   // The channel mode is encoded as a 2 bit value at the end of the 3nd byte,
@@ -261,31 +281,5 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   if(d->isPadded)
     d->frameLength += paddingSize[layerIndex];
 
-  if(checkLength) {
-
-    // Check if the frame length has been calculated correctly, or the next frame
-    // header is right next to the end of this frame.
-
-    // The MPEG versions, layers and sample rates of the two frames should be
-    // consistent. Otherwise, we assume that either or both of the frames are
-    // broken.
-
-    file->seek(offset + d->frameLength);
-    const ByteVector nextData = file->readBlock(4);
-
-    if(nextData.size() < 4)
-      return;
-
-    const unsigned int HeaderMask = 0xfffe0c00;
-
-    const unsigned int header     = data.toUInt(0, true)     & HeaderMask;
-    const unsigned int nextHeader = nextData.toUInt(0, true) & HeaderMask;
-
-    if(header != nextHeader)
-      return;
-  }
-
-  // Now that we're done parsing, set this to be a valid frame.
-
-  d->isValid = true;
+  return true;
 }
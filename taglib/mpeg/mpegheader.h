@@ -59,6 +59,14 @@ namespace TagLib {
        */
       Header(File *file, offset_t offset, bool checkLength = true);
 
+      /*!
+       * Parses an MPEG header from the first four bytes of \a data.
+       *
+       * \note Since there is no next frame to look at, the frame length is not
+       * checked.  This is meant for scanning a buffer for frame headers.
+       */
+      explicit Header(const ByteVector &data);
+
       /*!
        * Does a shallow copy of \a h.
        */
@@ -164,6 +172,7 @@ namespace TagLib {
 
     private:
       void parse(File *file, offset_t offset, bool checkLength);
+      bool parse(const ByteVector &data);
 
       class HeaderPrivate;
       std::shared_ptr<HeaderPrivate> d;
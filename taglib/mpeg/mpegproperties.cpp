@@ -25,14 +25,108 @@
 
 #include "mpegproperties.h"
 
+#include <algorithm>
+
 #include "tdebug.h"
 #include "mpegfile.h"
 #include "xingheader.h"
+#include "mpegutils.h"
 #include "apetag.h"
 #include "apefooter.h"
 
 using namespace TagLib;
 
+namespace
+{
+  // Returns the length of the frame with the header at data, or 0 if the
+  // header is not valid or does not belong to the stream whose first frame
+  // has firstHeader and the header bits streamBits.  Only the bitrate and
+  // the padding can differ from the first frame, so these are all that is
+  // decoded.  Unlike MPEG::Header, this does not allocate anything.
+
+  int frameLength(const unsigned char *data, unsigned int streamBits,
+                  const MPEG::Header &firstHeader)
+  {
+    const unsigned int bits = (static_cast<unsigned int>(data[0]) << 24) |
+                              (static_cast<unsigned int>(data[1]) << 16) |
+                              (static_cast<unsigned int>(data[2]) << 8) |
+                              static_cast<unsigned int>(data[3]);
+
+    // 0xFF in the second byte is not a frame sync, see MPEG::isFrameSync().
+
+    if(data[1] == 0xFF || (bits & MPEG::StreamHeaderMask) != streamBits)
+      return 0;
+
+    const int bitrate = MPEG::frameBitrate(firstHeader.version() == MPEG::Header::Version1,
+                                           firstHeader.layer(), (data[2] >> 4) & 0x0F);
+    if(bitrate == 0)
+      return 0;
+
+    int length = firstHeader.samplesPerFrame() * bitrate * 125 / firstHeader.sampleRate();
+    if((data[2] & 0x02) != 0)
+      length += firstHeader.layer() == 1 ? 4 : 1;
+
+    return length;
+  }
+
+  // Walks the headers of all frames of the stream starting with the frame at
+  // firstFrameOffset and ending at streamEnd, reading the stream in large
+  // blocks.  Frames whose version, layer and sample rate do not match the
+  // first one are skipped.  Returns the total number of samples and bytes of
+  // the frames in \a samples and \a bytes.
+
+  void walkFrames(MPEG::File *file, const MPEG::Header &firstHeader,
+                  offset_t firstFrameOffset, offset_t streamEnd,
+                  long long &samples, long long &bytes)
+  {
+    constexpr unsigned int blockSize = 64 * 1024;
+
+    samples = 0;
+    bytes = 0;
+
+    file->seek(firstFrameOffset);
+    const ByteVector firstData = file->readBlock(4);
+    if(firstData.size() < 4)
+      return;
+
+    const unsigned int streamBits = firstData.toUInt(0U, true) & MPEG::StreamHeaderMask;
+
+    offset_t position = firstFrameOffset;
+    while(position >= 0 && position + 4 <= streamEnd) {
+      file->seek(position);
+      const ByteVector block = file->readBlock(
+        static_cast<unsigned int>(std::min<offset_t>(blockSize, streamEnd - position)));
+      if(block.size() < 4)
+        return;
+
+      const auto data = reinterpret_cast<const unsigned char *>(block.data());
+      unsigned int offset = 0;
+      while(offset + 4 <= block.size()) {
+        const int length = frameLength(data + offset, streamBits, firstHeader);
+        if(length == 0)
+          break;
+
+        if(position + offset + length > streamEnd)
+          return;
+
+        samples += firstHeader.samplesPerFrame();
+        bytes += length;
+        offset += length;
+      }
+
+      if(offset + 4 <= block.size()) {
+
+        // Not a frame header, look for the next valid frame.
+
+        position = file->nextFrameOffset(position + offset + 1);
+      }
+      else {
+        position += offset;
+      }
+    }
+  }
+}  // namespace
+
 class MPEG::Properties::PropertiesPrivate
 {
 public:
@@ -57,7 +151,7 @@ MPEG::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(std::make_unique<PropertiesPrivate>())
 {
-  read(file);
+  read(file, style);
 }
 
 MPEG::Properties::~Properties() = default;
@@ -121,7 +215,7 @@ bool MPEG::Properties::isOriginal() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void MPEG::Properties::read(File *file)
+void MPEG::Properties::read(File *file, ReadStyle readStyle)
 {
   // Only the first valid frame is required if we have a VBR header.
 
@@ -155,10 +249,7 @@ void MPEG::Properties::read(File *file)
   else if(firstHeader.bitrate() > 0) {
 
     // Since there was no valid VBR header found, we hope that we're in a constant
-    // bitrate file.
-
-    // TODO: Make this more robust with audio property detection for VBR without a
-    // Xing header.
+    // bitrate file, unless we are asked to be accurate.
 
     d->bitrate = firstHeader.bitrate();
 
@@ -171,9 +262,28 @@ void MPEG::Properties::read(File *file)
     else
     {
       const Header lastHeader(file, lastFrameOffset, false);
-      const offset_t streamLength = lastFrameOffset - firstFrameOffset + lastHeader.frameLength();
-      if (streamLength > 0)
+      const offset_t streamEnd = lastFrameOffset + lastHeader.frameLength();
+      const offset_t streamLength = streamEnd - firstFrameOffset;
+
+      if(streamLength > 0)
         d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
+
+      if(readStyle == Accurate && firstHeader.sampleRate() > 0) {
+
+        // Walk all the frames to get the exact length and average bitrate of
+        // VBR streams without a VBR header.
+
+        long long samples;
+        long long bytes;
+        walkFrames(file, firstHeader, firstFrameOffset, streamEnd, samples, bytes);
+
+        if(samples > 0) {
+          const double length = samples * 1000.0 / firstHeader.sampleRate();
+
+          d->length  = static_cast<int>(length + 0.5);
+          d->bitrate = static_cast<int>(bytes * 8.0 / length + 0.5);
+        }
+      }
     }
   }
 
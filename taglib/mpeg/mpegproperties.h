@@ -50,6 +50,10 @@ namespace TagLib {
       /*!
        * Create an instance of MPEG::Properties with the data read from the
        * MPEG::File \a file.
+       *
+       * If the stream has no VBR header and \a style is Accurate, the headers
+       * of all frames are read to get the exact length and average bitrate.
+       * Otherwise the stream is assumed to have a constant bitrate.
        */
       Properties(File *file, ReadStyle style = Average);
 
@@ -120,7 +124,7 @@ namespace TagLib {
       bool isOriginal() const;
 
     private:
-      void read(File *file);
+      void read(File *file, ReadStyle readStyle);
 
       class PropertiesPrivate;
       std::unique_ptr<PropertiesPrivate> d;
@@ -30,6 +30,8 @@
 
 #ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
 
+#include <array>
+
 namespace TagLib
 {
   namespace MPEG
@@ -37,6 +39,13 @@ namespace TagLib
     namespace
     {
 
+      /*!
+       * The bits of a frame header which are the same in all frames of a
+       * stream: the synch bits, the MPEG version, the layer and the sample
+       * rate.
+       */
+      constexpr unsigned int StreamHeaderMask = 0xfffe0c00;
+
       /*!
        * MPEG frames can be recognized by the bit pattern 11111111 111, so the
        * first byte is easy to check for, however checking to see if the second byte
@@ -54,6 +63,48 @@ namespace TagLib
         return (b1 == 0xFF && b2 != 0xFF && (b2 & 0xE0) == 0xE0);
       }
 
+      /*!
+       * Returns true if the frame headers at \a offset1 of \a bytes1 and at
+       * \a offset2 of \a bytes2 have the same MPEG version, layer and sample
+       * rate, which is expected from two consecutive frames.
+       *
+       * \note This does not check the length of the vectors either.
+       */
+      inline bool isSameStream(const ByteVector &bytes1, unsigned int offset1,
+                               const ByteVector &bytes2, unsigned int offset2)
+      {
+        return (bytes1.toUInt(offset1, true) & StreamHeaderMask) ==
+               (bytes2.toUInt(offset2, true) & StreamHeaderMask);
+      }
+
+      /*!
+       * Returns the bitrate in kb/s encoded by \a bitrateIndex in a frame
+       * header of the MPEG \a layer, or 0 if the index is not valid.
+       * \a version1 is true for MPEG-1 and false for MPEG-2 and 2.5.
+       */
+      inline int frameBitrate(bool version1, int layer, int bitrateIndex)
+      {
+        static constexpr std::array bitrates {
+          std::array {
+            // Version 1
+            std::array { 0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0 }, // layer 1
+            std::array { 0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0 },    // layer 2
+            std::array { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 }      // layer 3
+          },
+          std::array {
+            // Version 2 or 2.5
+            std::array { 0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0 }, // layer 1
+            std::array { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 },      // layer 2
+            std::array { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 }       // layer 3
+          },
+        };
+
+        if(layer < 1 || layer > 3 || bitrateIndex < 0 || bitrateIndex > 15)
+          return 0;
+
+        return bitrates[version1 ? 0 : 1][layer - 1][bitrateIndex];
+      }
+
     }  // namespace
   }  // namespace MPEG
 }  // namespace TagLib
@@ -53,11 +53,15 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool Ogg::FLAC::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, bufferSize(), false));
+}
+
+bool Ogg::FLAC::File::isSupported(const ByteVector &data)
 {
   // An Ogg FLAC file has IDs "OggS" and "fLaC" somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("fLaC") >= 0);
+  return (data.find("OggS") >= 0 && data.find("fLaC") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
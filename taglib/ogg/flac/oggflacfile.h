@@ -153,6 +153,13 @@ namespace TagLib {
        */
       static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns whether or not a file starting with \a data can be opened as
+       * an Ogg FLAC file.  This does the same check as isSupported(IOStream *) on
+       * data which has already been read.
+       */
+      static bool isSupported(const ByteVector &data);
+
     private:
       void read(bool readProperties, Properties::ReadStyle propertiesStyle);
       void scan();
@@ -25,12 +25,15 @@
 
 #include "oggfile.h"
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "tdebug.h"
 #include "tmap.h"
 #include "oggpage.h"
 #include "oggpageheader.h"
+#include "oggutils.h"
 
 using namespace TagLib;
 
@@ -43,18 +46,91 @@ namespace
       return page->firstPacketIndex() + page->packetCount();
     return page->firstPacketIndex() + page->packetCount() - 1;
   }
+
+  // The Ogg CRC is linear: the checksum of a page in which some bytes have
+  // been changed is the old checksum XORed with the checksum of a page of the
+  // same size containing only the changed bits.  This lets us update the
+  // checksum without reading the page body.
+  //
+  // Returns the checksum of \a diff followed by \a zeroBytes zero bytes.
+  unsigned int checksumDelta(const ByteVector &diff, offset_t zeroBytes)
+  {
+    unsigned int sum = 0;
+    for(const auto &byte : diff) {
+      sum ^= static_cast<unsigned int>(static_cast<unsigned char>(byte)) << 24;
+      for(int i = 0; i < 8; ++i)
+        sum = (sum & 0x80000000) ? (sum << 1) ^ Ogg::crcPolynomial : sum << 1;
+    }
+
+    // Appending n zero bytes multiplies the checksum by x^(8n).
+
+    unsigned int power = 0x100;
+    while(zeroBytes > 0) {
+      if(zeroBytes & 1)
+        sum = Ogg::multiplyModulo(sum, power);
+      power = Ogg::multiplyModulo(power, power);
+      zeroBytes >>= 1;
+    }
+
+    return sum;
+  }
+
+  // Adds \a delta to the sequence number of the page at \a pageOffset and
+  // patches its checksum in place.  Only the page header is read, so unlike
+  // rendering the page again this does not repair a checksum which was
+  // already wrong.  Returns
+  // the size of the page, or 0 if there is no valid page at \a pageOffset.
+  // \a lastPage is set if the page is the last page of the stream.
+  offset_t renumberPage(File *file, offset_t pageOffset, int delta, bool &lastPage)
+  {
+    file->seek(pageOffset);
+    const ByteVector header = file->readBlock(27 + 255);
+
+    if(header.size() < 27 || !header.startsWith("OggS"))
+      return 0;
+
+    const unsigned int segmentCount = static_cast<unsigned char>(header[26]);
+    if(segmentCount < 1 || header.size() < 27 + segmentCount)
+      return 0;
+
+    offset_t pageSize = 27 + segmentCount;
+    for(unsigned int i = 0; i < segmentCount; ++i)
+      pageSize += static_cast<unsigned char>(header[27 + i]);
+
+    const unsigned int sequenceNumber = header.toUInt(18, false);
+    const unsigned int newSequenceNumber = sequenceNumber + delta;
+
+    // Bytes 18-21 hold the sequence number, 22-25 the checksum.
+
+    const unsigned int checksum = header.toUInt(22, false) ^
+      checksumDelta(ByteVector::fromUInt(sequenceNumber ^ newSequenceNumber, false), pageSize - 22);
+
+    ByteVector data = ByteVector::fromUInt(newSequenceNumber, false);
+    data.append(ByteVector::fromUInt(checksum, false));
+
+    file->seek(pageOffset + 18);
+    file->writeBlock(data);
+
+    lastPage = (header[5] & 0x04) != 0;
+    return pageSize;
+  }
 }  // namespace
 
 class Ogg::File::FilePrivate
 {
 public:
-  FilePrivate()
+  // Returns the index of the first page in which packet i starts, the page
+  // must have been read already.
+  size_t findPage(unsigned int i) const
   {
-    pages.setAutoDelete(true);
+    size_t index = 0;
+    while(pages[index]->containsPacket(i) == Page::DoesNotContainPacket)
+      ++index;
+    return index;
   }
 
   unsigned int streamSerialNumber;
-  List<Page *> pages;
+  std::vector<std::unique_ptr<Page>> pages;
   std::unique_ptr<PageHeader> firstPageHeader;
   std::unique_ptr<PageHeader> lastPageHeader;
   Map<unsigned int, ByteVector> dirtyPackets;
@@ -84,9 +160,7 @@ ByteVector Ogg::File::packet(unsigned int i)
 
   // Look for the first page in which the requested packet starts.
 
-  auto it = d->pages.cbegin();
-  while((*it)->containsPacket(i) == Page::DoesNotContainPacket)
-    ++it;
+  auto it = d->pages.cbegin() + d->findPage(i);
 
   // If the packet is completely contained in the first page that it's in.
 
@@ -97,7 +171,7 @@ ByteVector Ogg::File::packet(unsigned int i)
 
   ByteVector packet = (*it)->packets()[i - (*it)->firstPacketIndex()];
 
-  while(nextPacketIndex(*it) <= i) {
+  while(nextPacketIndex(it->get()) <= i) {
     ++it;
     packet.append((*it)->packets().front());
   }
@@ -182,14 +256,14 @@ bool Ogg::File::readPages(unsigned int i)
     unsigned int packetIndex;
     offset_t offset;
 
-    if(d->pages.isEmpty()) {
+    if(d->pages.empty()) {
       packetIndex = 0;
       offset = find("OggS");
       if(offset < 0)
         return false;
     }
     else {
-      const Page *page = d->pages.back();
+      const Page *page = d->pages.back().get();
       packetIndex = nextPacketIndex(page);
       offset = page->fileOffset() + page->size();
     }
@@ -201,16 +275,14 @@ bool Ogg::File::readPages(unsigned int i)
 
     // Read the next page and add it to the page list.
 
-    auto nextPage = new Page(this, offset);
-    if(!nextPage->header()->isValid()) {
-      delete nextPage;
+    auto nextPage = std::make_unique<Page>(this, offset);
+    if(!nextPage->header()->isValid())
       return false;
-    }
 
     nextPage->setFirstPacketIndex(packetIndex);
-    d->pages.append(nextPage);
+    d->pages.push_back(std::move(nextPage));
 
-    if(nextPage->header()->lastPageOfStream())
+    if(d->pages.back()->header()->lastPageOfStream())
       return false;
   }
 }
@@ -224,16 +296,14 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
 
   // Look for the pages where the requested packet should belong to.
 
-  auto it = d->pages.cbegin();
-  while((*it)->containsPacket(i) == Page::DoesNotContainPacket)
-    ++it;
+  auto it = d->pages.cbegin() + d->findPage(i);
 
-  const Page *firstPage = *it;
+  const Page *firstPage = it->get();
 
-  while(nextPacketIndex(*it) <= i)
+  while(nextPacketIndex(it->get()) <= i)
     ++it;
 
-  const Page *lastPage = *it;
+  const Page *lastPage = it->get();
 
   // Replace the requested packet and create new pages to replace the located pages.
 
@@ -275,22 +345,14 @@ void Ogg::File::writePacket(unsigned int i, const ByteVector &packet)
 
   if(numberOfNewPages != 0) {
     offset_t pageOffset = originalOffset + data.size();
+    bool lastPage = false;
 
-    while(true) {
-      Page page(this, pageOffset);
-      if(!page.header()->isValid())
-        break;
-
-      page.setPageSequenceNumber(page.pageSequenceNumber() + numberOfNewPages);
-      const ByteVector data = page.render();
-
-      seek(pageOffset + 18);
-      writeBlock(data.mid(18, 8));
-
-      if(page.header()->lastPageOfStream())
+    while(!lastPage) {
+      const offset_t pageSize = renumberPage(this, pageOffset, numberOfNewPages, lastPage);
+      if(pageSize == 0)
         break;
 
-      pageOffset += page.size();
+      pageOffset += pageSize;
     }
   }
 
@@ -0,0 +1,63 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_OGGUTILS_H
+#define TAGLIB_OGGUTILS_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib
+{
+  namespace Ogg
+  {
+    namespace
+    {
+
+      // The Ogg CRC is a plain CRC32 with this polynomial, no reflection, a
+      // zero initial value and no final XOR.
+
+      constexpr unsigned int crcPolynomial = 0x04c11db7;
+
+      // Returns a * b modulo the CRC polynomial.
+
+      inline unsigned int multiplyModulo(unsigned int a, unsigned int b)
+      {
+        unsigned int product = 0;
+        for(int i = 31; i >= 0; --i) {
+          product = (product & 0x80000000) ? (product << 1) ^ crcPolynomial : product << 1;
+          if(b & (1U << i))
+            product ^= a;
+        }
+        return product;
+      }
+
+    }  // namespace
+  }  // namespace Ogg
+}  // namespace TagLib
+
+#endif
+
+#endif
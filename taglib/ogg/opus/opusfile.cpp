@@ -48,11 +48,15 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool Ogg::Opus::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, bufferSize(), false));
+}
+
+bool Ogg::Opus::File::isSupported(const ByteVector &data)
 {
   // An Opus file has IDs "OggS" and "OpusHead" somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("OpusHead") >= 0);
+  return (data.find("OggS") >= 0 && data.find("OpusHead") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -48,11 +48,15 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool Ogg::Speex::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, bufferSize(), false));
+}
+
+bool Ogg::Speex::File::isSupported(const ByteVector &data)
 {
   // A Speex file has IDs "OggS" and "Speex   " somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("Speex   ") >= 0);
+  return (data.find("OggS") >= 0 && data.find("Speex   ") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,11 +51,15 @@ namespace TagLib {
 ////////////////////////////////////////////////////////////////////////////////
 
 bool Vorbis::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, bufferSize(), false));
+}
+
+bool Vorbis::File::isSupported(const ByteVector &data)
 {
   // An Ogg Vorbis file has IDs "OggS" and "\x01vorbis" somewhere.
 
-  const ByteVector buffer = Utils::readHeader(stream, bufferSize(), false);
-  return (buffer.find("OggS") >= 0 && buffer.find("\x01vorbis") >= 0);
+  return (data.find("OggS") >= 0 && data.find("\x01vorbis") >= 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
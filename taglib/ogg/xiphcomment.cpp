@@ -26,9 +26,11 @@
 #include "xiphcomment.h"
 
 #include <utility>
+#include <vector>
 
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tagutils.h"
 
 using namespace TagLib;
 
@@ -40,12 +42,57 @@ public:
     pictureList.setAutoDelete(true);
   }
 
+  // Decodes the pictures which have been found by parse() and appends them
+  // to the picture list.
+  void decodePictures();
+
   FieldListMap fieldListMap;
   String vendorID;
   String commentField;
   List<FLAC::Picture *> pictureList;
+
+  // Pictures are kept base64 encoded until they are accessed, the flag is
+  // true for METADATA_BLOCK_PICTURE and false for COVERART fields.
+  std::vector<std::pair<ByteVector, bool>> encodedPictures;
 };
 
+void Ogg::XiphComment::XiphCommentPrivate::decodePictures()
+{
+  for(const auto &[encoded, isPictureBlock] : encodedPictures) {
+    const ByteVector picturedata = ByteVector::fromBase64(encoded);
+    if(picturedata.isEmpty()) {
+      debug("Ogg::XiphComment - Discarding a picture. Invalid base64 data");
+      continue;
+    }
+
+    if(isPictureBlock) {
+
+      // Decode FLAC Picture
+
+      auto picture = new FLAC::Picture();
+      if(picture->parse(picturedata)) {
+        pictureList.append(picture);
+      }
+      else {
+        delete picture;
+        debug("Ogg::XiphComment - Failed to decode FLAC Picture block");
+      }
+    }
+    else {
+
+      // Assume it's some type of image file
+
+      auto picture = new FLAC::Picture();
+      picture->setData(picturedata);
+      picture->setMimeType("image/");
+      picture->setType(FLAC::Picture::Other);
+      pictureList.append(picture);
+    }
+  }
+
+  encodedPictures.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
@@ -189,7 +236,11 @@ unsigned int Ogg::XiphComment::fieldCount() const
   for(const auto &[_, list] : std::as_const(d->fieldListMap))
     count += list.size();
 
+  // The pictures are counted without decoding them, so that this does not
+  // modify the comment.
+
   count += d->pictureList.size();
+  count += static_cast<unsigned int>(d->encodedPictures.size());
 
   return count;
 }
@@ -294,6 +345,8 @@ bool Ogg::XiphComment::contains(const String &key) const
 
 void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 {
+  d->decodePictures();
+
   auto it = d->pictureList.find(picture);
   if(it != d->pictureList.end())
     d->pictureList.erase(it);
@@ -305,15 +358,18 @@ void Ogg::XiphComment::removePicture(FLAC::Picture *picture, bool del)
 void Ogg::XiphComment::removeAllPictures()
 {
   d->pictureList.clear();
+  d->encodedPictures.clear();
 }
 
 void Ogg::XiphComment::addPicture(FLAC::Picture * picture)
 {
+  d->decodePictures();
   d->pictureList.append(picture);
 }
 
 List<FLAC::Picture *> Ogg::XiphComment::pictureList()
 {
+  d->decodePictures();
   return d->pictureList;
 }
 
@@ -351,6 +407,17 @@ ByteVector Ogg::XiphComment::render(bool addFramingBit) const
     }
   }
 
+  // Pictures which have not been accessed are written as they were read,
+  // so that the number of fields matches even if some of them are invalid.
+  // Once the pictures are accessed there are no encoded ones left.
+
+  for(const auto &[encoded, isPictureBlock] : d->encodedPictures) {
+    const ByteVector key = isPictureBlock ? "METADATA_BLOCK_PICTURE=" : "COVERART=";
+    data.append(ByteVector::fromUInt(key.size() + encoded.size(), false));
+    data.append(key);
+    data.append(encoded);
+  }
+
   for(const auto &p : std::as_const(d->pictureList)) {
     ByteVector picture = p->render().toBase64();
     data.append(ByteVector::fromUInt(picture.size() + 23, false));
@@ -418,7 +485,7 @@ void Ogg::XiphComment::parse(const ByteVector &data)
 
     // Parse the key
 
-    const String key = String(entry.mid(0, sep), String::UTF8).upper();
+    const String key = Utils::internKey(String(entry.mid(0, sep), String::UTF8).upper());
     if(!checkKey(key)) {
       debug("Ogg::XiphComment::parse() - Discarding a field. Invalid key.");
       continue;
@@ -426,37 +493,9 @@ void Ogg::XiphComment::parse(const ByteVector &data)
 
     if(key == "METADATA_BLOCK_PICTURE" || key == "COVERART") {
 
-      // Handle Pictures separately
+      // Handle Pictures separately, they are decoded when accessed.
 
-      const ByteVector picturedata = ByteVector::fromBase64(entry.mid(sep + 1));
-      if(picturedata.isEmpty()) {
-        debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
-        continue;
-      }
-
-      if(key[0] == L'M') {
-
-        // Decode FLAC Picture
-
-        auto picture = new FLAC::Picture();
-        if(picture->parse(picturedata)) {
-          d->pictureList.append(picture);
-        }
-        else {
-          delete picture;
-          debug("Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
-        }
-      }
-      else {
-
-        // Assume it's some type of image file
-
-        auto picture = new FLAC::Picture();
-        picture->setData(picturedata);
-        picture->setMimeType("image/");
-        picture->setType(FLAC::Picture::Other);
-        d->pictureList.append(picture);
-      }
+      d->encodedPictures.emplace_back(entry.mid(sep + 1), key[0] == L'M');
     }
     else {
 
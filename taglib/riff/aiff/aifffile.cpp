@@ -45,11 +45,15 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool RIFF::AIFF::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 12, false));
+}
+
+bool RIFF::AIFF::File::isSupported(const ByteVector &data)
 {
   // An AIFF file has to start with "FORM????AIFF" or "FORM????AIFC".
 
-  const ByteVector id = Utils::readHeader(stream, 12, false);
-  return (id.startsWith("FORM") && (id.containsAt("AIFF", 8) || id.containsAt("AIFC", 8)));
+  return (data.startsWith("FORM") && (data.containsAt("AIFF", 8) || data.containsAt("AIFC", 8)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
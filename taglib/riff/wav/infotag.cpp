@@ -25,6 +25,7 @@
 
 #include "infotag.h"
 
+#include <atomic>
 #include <utility>
 
 #include "riffutils.h"
@@ -35,7 +36,7 @@ using namespace RIFF::Info;
 namespace
 {
   const RIFF::Info::StringHandler defaultStringHandler;
-  const RIFF::Info::StringHandler *stringHandler = &defaultStringHandler;
+  std::atomic<const RIFF::Info::StringHandler *> stringHandler = &defaultStringHandler;
 } // namespace
 
 class RIFF::Info::Tag::TagPrivate
@@ -199,7 +200,7 @@ ByteVector RIFF::Info::Tag::render() const
   ByteVector data("INFO");
 
   for(const auto &[field, list] : std::as_const(d->fieldListMap)) {
-    ByteVector text = stringHandler->render(list);
+    ByteVector text = stringHandler.load()->render(list);
     if(text.isEmpty())
       continue;
 
@@ -239,7 +240,7 @@ void RIFF::Info::Tag::parse(const ByteVector &data)
 
     const ByteVector id = data.mid(p, 4);
     if(isValidChunkName(id)) {
-      const String text = stringHandler->parse(data.mid(p + 8, size));
+      const String text = stringHandler.load()->parse(data.mid(p + 8, size));
       d->fieldListMap[id] = text;
     }
 
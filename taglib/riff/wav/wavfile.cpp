@@ -53,11 +53,15 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool RIFF::WAV::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 12, false));
+}
+
+bool RIFF::WAV::File::isSupported(const ByteVector &data)
 {
   // A WAV file has to start with "RIFF????WAVE".
 
-  const ByteVector id = Utils::readHeader(stream, 12, false);
-  return (id.startsWith("RIFF") && id.containsAt("WAVE", 8));
+  return (data.startsWith("RIFF") && data.containsAt("WAVE", 8));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
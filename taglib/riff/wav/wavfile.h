@@ -194,6 +194,13 @@ namespace TagLib {
          */
         static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns whether or not a file starting with \a data can be opened as
+       * a WAV file.  This does the same check as isSupported(IOStream *) on
+       * data which has already been read.
+       */
+      static bool isSupported(const ByteVector &data);
+
       private:
         void read(bool readProperties);
         void removeTagChunks(TagTypes tags);
@@ -25,6 +25,9 @@
 
 #include "tagutils.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "tfile.h"
 
 #include "id3v1tag.h"
@@ -114,3 +117,45 @@ ByteVector TagLib::Utils::readHeader(IOStream *stream, unsigned int length,
 
   return header;
 }
+
+String Utils::internKey(const String &key)
+{
+  static const std::vector<String> keys = [] {
+    static const char *const names[] = {
+      // Property map keys
+      "TITLE", "ALBUM", "ARTIST", "ALBUMARTIST", "SUBTITLE", "TRACKNUMBER",
+      "DISCNUMBER", "DATE", "ORIGINALDATE", "GENRE", "COMMENT", "TITLESORT",
+      "ALBUMSORT", "ARTISTSORT", "ALBUMARTISTSORT", "COMPOSERSORT", "COMPOSER",
+      "LYRICIST", "CONDUCTOR", "REMIXER", "ISRC", "ASIN", "BPM", "COPYRIGHT",
+      "ENCODEDBY", "ENCODING", "MOOD", "MEDIA", "LABEL", "CATALOGNUMBER",
+      "BARCODE", "RELEASECOUNTRY", "RELEASESTATUS", "RELEASETYPE", "LYRICS",
+      "COMPILATION", "LANGUAGE", "TRACKTOTAL", "DISCTOTAL", "TOTALTRACKS",
+      "TOTALDISCS", "YEAR", "DESCRIPTION", "VENDOR", "REPLAYGAIN_TRACK_GAIN",
+      "REPLAYGAIN_TRACK_PEAK", "REPLAYGAIN_ALBUM_GAIN", "REPLAYGAIN_ALBUM_PEAK",
+      "MUSICBRAINZ_TRACKID", "MUSICBRAINZ_ALBUMID", "MUSICBRAINZ_RELEASEGROUPID",
+      "MUSICBRAINZ_RELEASETRACKID", "MUSICBRAINZ_WORKID", "MUSICBRAINZ_ARTISTID",
+      "MUSICBRAINZ_ALBUMARTISTID", "ACOUSTID_ID", "ACOUSTID_FINGERPRINT",
+      "MUSICIP_PUID", "METADATA_BLOCK_PICTURE",
+      // MP4 item keys
+      "\251nam", "\251ART", "aART", "\251alb", "\251cmt", "\251gen", "\251day",
+      "trkn", "disk", "\251wrt", "\251too", "\251lyr", "\251grp", "cpil", "tmpo",
+      "covr", "cprt", "pgap", "soal", "soar", "soaa", "sonm", "soco",
+      // ASF attribute names
+      "WM/AlbumTitle", "WM/AlbumArtist", "WM/Composer", "WM/Genre", "WM/Year",
+      "WM/TrackNumber", "WM/PartOfSet", "WM/Lyrics", "WM/Publisher",
+      "WM/EncodedBy", "WM/EncodingSettings", "WM/Picture", "WM/MediaPrimaryClassID",
+      "WM/Provider", "WM/ProviderRating", "WM/ProviderStyle", "WM/WMContentID",
+      "WM/WMCollectionID", "WM/WMCollectionGroupID", "WM/UniqueFileIdentifier",
+      "IsVBR", "DeviceConformanceTemplate"
+    };
+    std::vector<String> k(std::begin(names), std::end(names));
+    std::sort(k.begin(), k.end());
+    return k;
+  }();
+
+  const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+  if(it != keys.end() && *it == key)
+    return *it;
+
+  return key;
+}
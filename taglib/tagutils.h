@@ -31,6 +31,7 @@
 #ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
 
 #include "tbytevector.h"
+#include "tstring.h"
 
 namespace TagLib {
 
@@ -47,6 +48,13 @@ namespace TagLib {
 
     ByteVector readHeader(IOStream *stream, unsigned int length, bool skipID3v2,
                           offset_t *headerOffset = nullptr);
+
+    /*!
+     * Returns a shared copy of \a key if it is one of the well-known property
+     * or item keys, otherwise \a key itself.  The maps of many files then
+     * share the data of their keys and comparing equal keys is cheap.
+     */
+    String internKey(const String &key);
   }  // namespace Utils
 }  // namespace TagLib
 
@@ -108,6 +108,57 @@ int findVector(
   return -1;
 }
 
+// Specialized version of findVector() for forward searches without alignment,
+// which is by far the most common case.  memchr() is used to skip to the
+// candidate positions, since C runtimes implement it with SIMD instructions.
+
+int findBytes(
+  const char *dataBegin, size_t dataSize,
+  const char *patternBegin, size_t patternSize,
+  unsigned int offset)
+{
+  if(patternSize == 0 || offset + patternSize > dataSize)
+    return -1;
+
+  const char *it   = dataBegin + offset;
+  const char *last = dataBegin + dataSize - patternSize;
+
+  while(it <= last) {
+    it = static_cast<const char *>(::memchr(it, *patternBegin, last - it + 1));
+    if(!it)
+      return -1;
+
+    if(::memcmp(it + 1, patternBegin + 1, patternSize - 1) == 0)
+      return static_cast<int>(it - dataBegin);
+
+    ++it;
+  }
+
+  return -1;
+}
+
+// Backward counterpart of findBytes().  \a offset is counted from the end of
+// the data, like in findVector() with reverse iterators.
+
+int rfindBytes(
+  const char *dataBegin, size_t dataSize,
+  const char *patternBegin, size_t patternSize,
+  unsigned int offset)
+{
+  if(patternSize == 0 || offset + patternSize > dataSize)
+    return -1;
+
+  for(const char *it = dataBegin + dataSize - offset - patternSize; ; --it) {
+    if(*it == *patternBegin && ::memcmp(it + 1, patternBegin + 1, patternSize - 1) == 0)
+      return static_cast<int>(it - dataBegin);
+
+    if(it == dataBegin)
+      break;
+  }
+
+  return -1;
+}
+
 template <class T>
 T toNumber(const ByteVector &v, size_t offset, size_t length, bool mostSignificantByteFirst)
 {
@@ -246,16 +297,36 @@ long double toFloat80(const ByteVector &v, size_t offset)
   return val;
 }
 
+namespace
+{
+  // All empty byte vectors share the same buffer, so that creating one only
+  // costs the allocation of its private data.  The buffer is never written to,
+  // since it is always shared and thus detached from before modifications.
+
+  const std::shared_ptr<std::vector<char>> &emptyData()
+  {
+    static const auto data = std::make_shared<std::vector<char>>();
+    return data;
+  }
+
+  std::shared_ptr<std::vector<char>> createData(const char *s, unsigned int l)
+  {
+    if(l == 0)
+      return emptyData();
+    return std::make_shared<std::vector<char>>(s, s + l);
+  }
+}  // namespace
+
 class ByteVector::ByteVectorPrivate
 {
 public:
   ByteVectorPrivate(unsigned int l, char c) :
-    data(std::make_shared<std::vector<char>>(l, c)),
+    data(l > 0 ? std::make_shared<std::vector<char>>(l, c) : emptyData()),
     offset(0),
     length(l) { }
 
   ByteVectorPrivate(const char *s, unsigned int l) :
-    data(std::make_shared<std::vector<char>>(s, s + l)),
+    data(createData(s, l)),
     offset(0),
     length(l) { }
 
@@ -360,14 +431,18 @@ ByteVector::~ByteVector() = default;
 
 ByteVector &ByteVector::setData(const char *s, unsigned int length)
 {
-  ByteVector(s, length).swap(*this);
+  // Keep the private data, only replace the buffer.  The new buffer is created
+  // before the old one is released, since s may point into it.
+
+  d->data   = createData(s, length);
+  d->offset = 0;
+  d->length = length;
   return *this;
 }
 
 ByteVector &ByteVector::setData(const char *data)
 {
-  ByteVector(data).swap(*this);
-  return *this;
+  return setData(data, static_cast<unsigned int>(::strlen(data)));
 }
 
 char *ByteVector::data()
@@ -396,12 +471,18 @@ char ByteVector::at(unsigned int index) const
 
 int ByteVector::find(const ByteVector &pattern, unsigned int offset, int byteAlign) const
 {
+  if(byteAlign == 1)
+    return findBytes(data(), size(), pattern.data(), pattern.size(), offset);
+
   return findVector<ConstIterator>(
     begin(), end(), pattern.begin(), pattern.end(), offset, byteAlign);
 }
 
 int ByteVector::find(char c, unsigned int offset, int byteAlign) const
 {
+  if(byteAlign == 1)
+    return findBytes(data(), size(), &c, 1, offset);
+
   return findChar<ConstIterator>(begin(), end(), c, offset, byteAlign);
 }
 
@@ -413,6 +494,9 @@ int ByteVector::rfind(const ByteVector &pattern, unsigned int offset, int byteAl
       offset = 0;
   }
 
+  if(byteAlign == 1)
+    return rfindBytes(data(), size(), pattern.data(), pattern.size(), offset);
+
   const int pos = findVector<ConstReverseIterator>(
     rbegin(), rend(), pattern.rbegin(), pattern.rend(), offset, byteAlign);
 
@@ -556,7 +640,9 @@ ByteVector &ByteVector::append(char c)
 
 ByteVector &ByteVector::clear()
 {
-  ByteVector().swap(*this);
+  d->data   = emptyData();
+  d->offset = 0;
+  d->length = 0;
   return *this;
 }
 
@@ -782,20 +868,22 @@ ByteVector ByteVector::operator+(const ByteVector &v) const
 
 ByteVector &ByteVector::operator=(const ByteVector &v)
 {
-  ByteVector(v).swap(*this);
+  if(&v != this) {
+    d->data   = v.d->data;
+    d->offset = v.d->offset;
+    d->length = v.d->length;
+  }
   return *this;
 }
 
 ByteVector &ByteVector::operator=(char c)
 {
-  ByteVector(c).swap(*this);
-  return *this;
+  return setData(&c, 1);
 }
 
 ByteVector &ByteVector::operator=(const char *data)
 {
-  ByteVector(data).swap(*this);
-  return *this;
+  return setData(data);
 }
 
 void ByteVector::swap(ByteVector &v)
@@ -945,10 +1033,9 @@ ByteVector ByteVector::toBase64() const
 void ByteVector::detach()
 {
   if(d->data.use_count() > 1) {
-    if(!isEmpty())
-      ByteVector(&d->data->front() + d->offset, d->length).swap(*this);
-    else
-      ByteVector().swap(*this);
+    const auto begin = d->data->cbegin() + d->offset;
+    d->data   = std::make_shared<std::vector<char>>(begin, begin + d->length);
+    d->offset = 0;
   }
 }
 }  // namespace TagLib
@@ -0,0 +1,242 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tcachediostream.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+  struct Block
+  {
+    offset_t index;
+    ByteVector data;
+    unsigned long long lastUse;
+  };
+}  // namespace
+
+class CachedIOStream::CachedIOStreamPrivate
+{
+public:
+  CachedIOStreamPrivate(IOStream *stream, unsigned int blockSize, unsigned int blockCount) :
+    stream(stream),
+    blockSize(std::max(blockSize, 1U)),
+    blockCount(std::max(blockCount, 1U))
+  {
+  }
+
+  // Returns the block with the given index, reading it from the wrapped
+  // stream and evicting the least recently used block if necessary.  The
+  // block is short (or empty) at the end of the stream.
+
+  const ByteVector &block(offset_t index)
+  {
+    ++useCounter;
+
+    for(auto &b : blocks) {
+      if(b.index == index) {
+        b.lastUse = useCounter;
+        return b.data;
+      }
+    }
+
+    stream->seek(index * blockSize);
+    ByteVector data = stream->readBlock(blockSize);
+
+    if(blocks.size() < blockCount) {
+      blocks.push_back({index, std::move(data), useCounter});
+      return blocks.back().data;
+    }
+
+    auto oldest = std::min_element(blocks.begin(), blocks.end(),
+      [](const Block &a, const Block &b) { return a.lastUse < b.lastUse; });
+    *oldest = {index, std::move(data), useCounter};
+    return oldest->data;
+  }
+
+  // Drops all cached data after the wrapped stream was modified and takes
+  // over its new position.
+
+  void invalidate()
+  {
+    blocks.clear();
+    streamLength = -1;
+    position = stream->tell();
+  }
+
+  IOStream *const stream;
+  const unsigned int blockSize;
+  const unsigned int blockCount;
+  std::vector<Block> blocks;
+  unsigned long long useCounter { 0 };
+  offset_t position { 0 };
+  offset_t streamLength { -1 };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+CachedIOStream::CachedIOStream(IOStream *stream, unsigned int blockSize,
+                               unsigned int blockCount) :
+  d(std::make_unique<CachedIOStreamPrivate>(stream, blockSize, blockCount))
+{
+  d->position = d->stream->tell();
+}
+
+CachedIOStream::~CachedIOStream() = default;
+
+FileName CachedIOStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector CachedIOStream::readBlock(size_t length)
+{
+  if(length == 0)
+    return ByteVector();
+
+  // Blocks which would take up a good part of the cache are read directly,
+  // so that e.g. reading the audio data does not flush the headers.
+
+  if(length >= static_cast<size_t>(d->blockSize) * d->blockCount / 2) {
+    d->stream->seek(d->position);
+    ByteVector data = d->stream->readBlock(length);
+    d->position += data.size();
+    return data;
+  }
+
+  ByteVector result;
+
+  while(length > 0) {
+    const offset_t index = d->position / d->blockSize;
+    const ByteVector &data = d->block(index);
+    const auto offset = static_cast<unsigned int>(d->position - index * d->blockSize);
+
+    if(offset >= data.size())
+      break;
+
+    const auto count = static_cast<unsigned int>(
+      std::min<size_t>(length, data.size() - offset));
+
+    // The first piece shares the cached buffer instead of copying it.
+
+    if(result.isEmpty())
+      result = data.mid(offset, count);
+    else
+      result.append(data.mid(offset, count));
+
+    d->position += count;
+    length -= count;
+
+    if(data.size() < d->blockSize)
+      break;
+  }
+
+  return result;
+}
+
+void CachedIOStream::writeBlock(const ByteVector &data)
+{
+  d->stream->seek(d->position);
+  d->stream->writeBlock(data);
+  d->invalidate();
+}
+
+void CachedIOStream::insert(const ByteVector &data, offset_t start, size_t replace)
+{
+  d->stream->insert(data, start, replace);
+  d->invalidate();
+}
+
+void CachedIOStream::removeBlock(offset_t start, size_t length)
+{
+  d->stream->removeBlock(start, length);
+  d->invalidate();
+}
+
+bool CachedIOStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool CachedIOStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void CachedIOStream::seek(offset_t offset, Position p)
+{
+  offset_t position;
+  switch(p) {
+  case Beginning:
+    position = offset;
+    break;
+  case Current:
+    position = d->position + offset;
+    break;
+  case End:
+    position = length() + offset;
+    break;
+  default:
+    debug("CachedIOStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  if(position < 0) {
+    debug("CachedIOStream::seek() -- Invalid offset.");
+    return;
+  }
+
+  d->position = position;
+}
+
+void CachedIOStream::clear()
+{
+  d->stream->clear();
+}
+
+offset_t CachedIOStream::tell() const
+{
+  return d->position;
+}
+
+offset_t CachedIOStream::length()
+{
+  if(d->streamLength < 0)
+    d->streamLength = d->stream->length();
+  return d->streamLength;
+}
+
+void CachedIOStream::truncate(offset_t length)
+{
+  d->stream->truncate(length);
+  d->invalidate();
+}
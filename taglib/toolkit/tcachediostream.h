@@ -0,0 +1,144 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_CACHEDIOSTREAM_H
+#define TAGLIB_CACHEDIOSTREAM_H
+
+#include "tbytevector.h"
+#include "tiostream.h"
+#include "taglib_export.h"
+#include "taglib.h"
+
+namespace TagLib {
+
+  //! An IOStream which reads another stream in large cached blocks
+
+  /*!
+   * Parsers typically issue many small reads, e.g. for the headers of atoms,
+   * chunks or pages.  This stream serves them from a small cache of aligned
+   * blocks read from the wrapped stream, so that a stream with a high
+   * latency per request (e.g. on a network file system or an object store)
+   * only sees a few large reads.  The least recently used block is dropped
+   * when the cache is full.
+   *
+   * \code
+   * TagLib::FileStream stream("song.m4a");
+   * TagLib::CachedIOStream cache(&stream);
+   * TagLib::FileRef f(&cache);
+   * \endcode
+   *
+   * Writing through this stream is supported and empties the cache.  The
+   * wrapped stream must not be modified by other means while it is wrapped.
+   */
+
+  class TAGLIB_EXPORT CachedIOStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a CachedIOStream wrapping \a stream, caching up to
+     * \a blockCount blocks of \a blockSize bytes.  The stream is not owned
+     * and must outlive this instance.
+     */
+    explicit CachedIOStream(IOStream *stream, unsigned int blockSize = 64 * 1024,
+                            unsigned int blockCount = 16);
+
+    /*!
+     * Destroys this CachedIOStream instance.
+     */
+    ~CachedIOStream() override;
+
+    CachedIOStream(const CachedIOStream &) = delete;
+    CachedIOStream &operator=(const CachedIOStream &) = delete;
+
+    /*!
+     * Returns the name of the wrapped stream.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.  Large
+     * blocks are read from the wrapped stream directly.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Writes \a data to the wrapped stream at the current get pointer.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Inserts \a data into the wrapped stream.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Removes a block from the wrapped stream.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns true if the wrapped stream is read only.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns true if the wrapped stream is open.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the stream from position \a p.
+     * This does not access the wrapped stream unless \a p is End and the
+     * length is not known yet.
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Resets the end-of-stream and error flags of the wrapped stream.
+     */
+    void clear() override;
+
+    /*!
+     * Returns the current offset within the stream.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the stream.
+     */
+    offset_t length() override;
+
+    /*!
+     * Truncates the wrapped stream to \a length.
+     */
+    void truncate(offset_t length) override;
+
+  private:
+    class CachedIOStreamPrivate;
+    std::unique_ptr<CachedIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
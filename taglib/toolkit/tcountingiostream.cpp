@@ -0,0 +1,167 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tcountingiostream.h"
+
+#include <chrono>
+
+using namespace TagLib;
+
+namespace
+{
+  // Adds the time from its construction to its destruction to a counter.
+
+  class Timer
+  {
+  public:
+    explicit Timer(long long &nanoseconds) :
+      nanoseconds(nanoseconds),
+      start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~Timer()
+    {
+      nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    }
+
+    Timer(const Timer &) = delete;
+    Timer &operator=(const Timer &) = delete;
+
+  private:
+    long long &nanoseconds;
+    const std::chrono::steady_clock::time_point start;
+  };
+}  // namespace
+
+class CountingIOStream::CountingIOStreamPrivate
+{
+public:
+  CountingIOStreamPrivate(IOStream *stream) :
+    stream(stream)
+  {
+  }
+
+  IOStream *const stream;
+  IOStatistics statistics;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+CountingIOStream::CountingIOStream(IOStream *stream) :
+  d(std::make_unique<CountingIOStreamPrivate>(stream))
+{
+}
+
+CountingIOStream::~CountingIOStream() = default;
+
+const IOStatistics &CountingIOStream::statistics() const
+{
+  return d->statistics;
+}
+
+void CountingIOStream::resetStatistics()
+{
+  d->statistics = IOStatistics();
+}
+
+FileName CountingIOStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector CountingIOStream::readBlock(size_t length)
+{
+  Timer timer(d->statistics.nanoseconds);
+  ByteVector data = d->stream->readBlock(length);
+  d->statistics.readCalls++;
+  d->statistics.bytesRead += data.size();
+  return data;
+}
+
+void CountingIOStream::writeBlock(const ByteVector &data)
+{
+  Timer timer(d->statistics.nanoseconds);
+  d->stream->writeBlock(data);
+  d->statistics.writeCalls++;
+  d->statistics.bytesWritten += data.size();
+}
+
+void CountingIOStream::insert(const ByteVector &data, offset_t start, size_t replace)
+{
+  Timer timer(d->statistics.nanoseconds);
+  d->stream->insert(data, start, replace);
+  d->statistics.insertCalls++;
+  d->statistics.bytesWritten += data.size();
+}
+
+void CountingIOStream::removeBlock(offset_t start, size_t length)
+{
+  Timer timer(d->statistics.nanoseconds);
+  d->stream->removeBlock(start, length);
+  d->statistics.removeCalls++;
+}
+
+bool CountingIOStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool CountingIOStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void CountingIOStream::seek(offset_t offset, Position p)
+{
+  Timer timer(d->statistics.nanoseconds);
+  d->stream->seek(offset, p);
+  d->statistics.seekCalls++;
+}
+
+void CountingIOStream::clear()
+{
+  d->stream->clear();
+}
+
+offset_t CountingIOStream::tell() const
+{
+  return d->stream->tell();
+}
+
+offset_t CountingIOStream::length()
+{
+  return d->stream->length();
+}
+
+void CountingIOStream::truncate(offset_t length)
+{
+  Timer timer(d->statistics.nanoseconds);
+  d->stream->truncate(length);
+  d->statistics.truncateCalls++;
+}
@@ -0,0 +1,150 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_COUNTINGIOSTREAM_H
+#define TAGLIB_COUNTINGIOSTREAM_H
+
+#include "tbytevector.h"
+#include "tiostream.h"
+#include "taglib_export.h"
+#include "taglib.h"
+
+namespace TagLib {
+
+  //! An IOStream which counts the operations done on another stream
+
+  /*!
+   * This stream forwards all calls to the wrapped stream and records the
+   * number of calls, the bytes transferred and the time spent in them.  Wrap
+   * the stream passed to FileRef or one of the File constructors in it to
+   * find out what opening or saving a file costs:
+   *
+   * \code
+   * TagLib::FileStream stream("song.flac");
+   * TagLib::CountingIOStream counter(&stream);
+   * TagLib::FileRef f(&counter);
+   * const TagLib::IOStatistics &s = counter.statistics();
+   * \endcode
+   *
+   * Unlike File::ioStatistics(), this includes the I/O done by FileRef to
+   * detect the file type.
+   */
+
+  class TAGLIB_EXPORT CountingIOStream : public IOStream
+  {
+  public:
+    /*!
+     * Constructs a CountingIOStream wrapping \a stream.  The stream is not
+     * owned and must outlive this instance.
+     */
+    explicit CountingIOStream(IOStream *stream);
+
+    /*!
+     * Destroys this CountingIOStream instance.
+     */
+    ~CountingIOStream() override;
+
+    CountingIOStream(const CountingIOStream &) = delete;
+    CountingIOStream &operator=(const CountingIOStream &) = delete;
+
+    /*!
+     * Returns the counters collected since the construction or the last call
+     * to resetStatistics().
+     */
+    const IOStatistics &statistics() const;
+
+    /*!
+     * Sets all the counters to zero.
+     */
+    void resetStatistics();
+
+    /*!
+     * Returns the name of the wrapped stream.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length from the wrapped stream.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Writes \a data to the wrapped stream.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Inserts \a data into the wrapped stream.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Removes a block from the wrapped stream.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Returns true if the wrapped stream is read only.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns true if the wrapped stream is open.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Moves the I/O pointer of the wrapped stream.
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Resets the end-of-stream and error flags of the wrapped stream.
+     */
+    void clear() override;
+
+    /*!
+     * Returns the current offset within the wrapped stream.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the wrapped stream.
+     */
+    offset_t length() override;
+
+    /*!
+     * Truncates the wrapped stream to \a length.
+     */
+    void truncate(offset_t length) override;
+
+  private:
+    class CountingIOStreamPrivate;
+    std::unique_ptr<CountingIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
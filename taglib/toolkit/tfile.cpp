@@ -25,9 +25,14 @@
 
 #include "tfile.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "tfilestream.h"
+#include "tmmapfilestream.h"
 #include "tpropertymap.h"
 #include "tstring.h"
+#include "tdebug.h"
 
 #ifdef _WIN32
 # include <windows.h>
@@ -47,6 +52,177 @@
 
 using namespace TagLib;
 
+namespace
+{
+  // The largest buffer used to scan or move the contents of the file.
+
+  constexpr unsigned int maxBufferSize()
+  {
+    return 1024 * 1024;
+  }
+
+  // A part of the file being edited.  It is either a range of the original
+  // file starting at sourceOffset, or new data if sourceOffset is negative.
+  // New data without any bytes stands for length zeros, which are only
+  // written in blocks when the transaction is committed.
+
+  struct EditSegment
+  {
+    offset_t sourceOffset;
+    offset_t length;
+    ByteVector data;
+  };
+
+  // Appends \a length bytes of \a segment starting at \a offset to
+  // \a segments, merging it with the previous one if they are contiguous
+  // ranges of the original file.
+
+  void appendSegment(std::vector<EditSegment> &segments, const EditSegment &segment,
+                     offset_t offset, offset_t length)
+  {
+    if(length <= 0)
+      return;
+
+    if(segment.sourceOffset < 0) {
+      if(segment.data.isEmpty())
+        segments.push_back({ -1, length, ByteVector() });
+      else
+        segments.push_back({ -1, length, segment.data.mid(static_cast<unsigned int>(offset),
+                                                          static_cast<unsigned int>(length)) });
+      return;
+    }
+
+    const offset_t sourceOffset = segment.sourceOffset + offset;
+    if(!segments.empty() && segments.back().sourceOffset >= 0 &&
+       segments.back().sourceOffset + segments.back().length == sourceOffset) {
+      segments.back().length += length;
+      return;
+    }
+
+    segments.push_back({ sourceOffset, length, ByteVector() });
+  }
+
+  // Returns the offset of the first occurrence of \a pattern in \a buffer
+  // or -1.  \a stop is set if \a before occurs first.
+
+  offset_t findInBuffer(const ByteVector &buffer, const ByteVector &pattern,
+                        const ByteVector &before, bool &stop)
+  {
+    const int location = buffer.find(pattern);
+    if(!before.isEmpty()) {
+      const int beforeLocation = buffer.find(before);
+      if(beforeLocation >= 0 && (location < 0 || beforeLocation < location)) {
+        stop = true;
+        return -1;
+      }
+    }
+    return location;
+  }
+
+  // Returns the offset of the last occurrence of \a pattern in \a buffer
+  // or -1.  \a stop is set if \a before occurs after it.
+
+  offset_t rfindInBuffer(const ByteVector &buffer, const ByteVector &pattern,
+                         const ByteVector &before, bool &stop)
+  {
+    const int location = buffer.rfind(pattern);
+    if(!before.isEmpty()) {
+      const int beforeLocation = buffer.rfind(before);
+      if(beforeLocation >= 0 && beforeLocation > location) {
+        stop = true;
+        return -1;
+      }
+    }
+    return location;
+  }
+
+  // Replaces \a replace bytes at \a start of the edited file of length
+  // \a editLength, which is made up of \a editSegments, by \a data, or by
+  // \a zeros zero bytes if \a data is empty.
+
+  void spliceSegments(std::vector<EditSegment> &editSegments, offset_t &editLength,
+                      const ByteVector &data, offset_t start, offset_t replace,
+                      offset_t zeros = 0)
+  {
+    start = std::min(std::max<offset_t>(start, 0), editLength);
+    const offset_t end = std::min<offset_t>(start + replace, editLength);
+
+    // Rebuild the list from the parts before the replaced range, the new data
+    // and the parts after the replaced range.
+
+    std::vector<EditSegment> segments;
+    segments.reserve(editSegments.size() + 2);
+
+    offset_t segmentOffset = 0;
+    for(const auto &segment : editSegments) {
+      if(segmentOffset < start)
+        appendSegment(segments, segment, 0, std::min(segment.length, start - segmentOffset));
+      segmentOffset += segment.length;
+    }
+
+    const offset_t length = data.isEmpty() ? zeros : static_cast<offset_t>(data.size());
+    if(length > 0)
+      segments.push_back({ -1, length, data });
+
+    segmentOffset = 0;
+    for(const auto &segment : editSegments) {
+      const offset_t segmentEnd = segmentOffset + segment.length;
+      if(segmentEnd > end) {
+        const offset_t tailOffset = std::max(end, segmentOffset) - segmentOffset;
+        appendSegment(segments, segment, tailOffset, segment.length - tailOffset);
+      }
+      segmentOffset = segmentEnd;
+    }
+
+    editSegments.swap(segments);
+    editLength += length - (end - start);
+  }
+
+  // Writes \a length zero bytes at the current position of \a file.
+
+  void writeZeros(File *file, offset_t length)
+  {
+    const ByteVector zeros(static_cast<unsigned int>(std::min<offset_t>(length, maxBufferSize())), '\0');
+    for(offset_t done = 0; done < length; done += zeros.size()) {
+      if(length - done < zeros.size())
+        file->writeBlock(zeros.mid(0, static_cast<unsigned int>(length - done)));
+      else
+        file->writeBlock(zeros);
+    }
+  }
+
+  // Moves \a length bytes of \a file from \a from to \a to, reading the data
+  // in an order that never overwrites bytes which have not been moved yet.
+
+  void moveBlock(File *file, offset_t from, offset_t to, offset_t length)
+  {
+    ByteVector buffer;
+
+    if(to < from) {
+      for(offset_t done = 0; done < length; ) {
+        const auto bufferLength = static_cast<size_t>(std::min<offset_t>(length - done, maxBufferSize()));
+        file->seek(from + done);
+        buffer = file->readBlock(bufferLength);
+        file->clear();
+        file->seek(to + done);
+        file->writeBlock(buffer);
+        done += bufferLength;
+      }
+    }
+    else {
+      for(offset_t remaining = length; remaining > 0; ) {
+        const auto bufferLength = static_cast<size_t>(std::min<offset_t>(remaining, maxBufferSize()));
+        remaining -= bufferLength;
+        file->seek(from + remaining);
+        buffer = file->readBlock(bufferLength);
+        file->clear();
+        file->seek(to + remaining);
+        file->writeBlock(buffer);
+      }
+    }
+  }
+}  // namespace
+
 class File::FilePrivate
 {
 public:
@@ -68,6 +244,13 @@ public:
   IOStream *stream;
   bool streamOwner;
   bool valid { true };
+  IOStatistics statistics;
+
+  // Pending changes while an edit transaction is open.
+
+  bool editing { false };
+  offset_t editLength { 0 };
+  std::vector<EditSegment> editSegments;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -79,6 +262,13 @@ File::File(FileName fileName) :
 {
 }
 
+File::File(FileName fileName, StreamBackend backend) :
+  d(std::make_unique<FilePrivate>(
+      backend == MemoryMapped ? static_cast<IOStream *>(new MMapFileStream(fileName))
+                              : static_cast<IOStream *>(new FileStream(fileName)), true))
+{
+}
+
 File::File(IOStream *stream) :
   d(std::make_unique<FilePrivate>(stream, false))
 {
@@ -108,97 +298,74 @@ PropertyMap File::setProperties(const PropertyMap &properties)
 
 ByteVector File::readBlock(size_t length)
 {
-  return d->stream->readBlock(length);
+  ByteVector data = d->stream->readBlock(length);
+  d->statistics.readCalls++;
+  d->statistics.bytesRead += data.size();
+  return data;
 }
 
 void File::writeBlock(const ByteVector &data)
 {
   d->stream->writeBlock(data);
+  d->statistics.writeCalls++;
+  d->statistics.bytesWritten += data.size();
 }
 
 offset_t File::find(const ByteVector &pattern, offset_t fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.isEmpty() || pattern.size() > bufferSize())
       return -1;
 
-  // The position in the file that the current buffer starts at.
+  // Save the location of the current read pointer.  We will restore the
+  // position using seek() before all returns.
 
-  offset_t bufferOffset = fromOffset;
+  const offset_t originalPosition = tell();
 
-  // These variables are used to keep track of a partial match that happens at
-  // the end of a buffer.
+  // Matches which span two buffers are found by searching the last few bytes
+  // of the previous buffer joined with the first few bytes of the current one,
+  // so we have to keep one byte less than the longest pattern.
 
-  int previousPartialMatch = -1;
-  int beforePreviousPartialMatch = -1;
+  const unsigned int overlap = std::max(pattern.size(), before.size()) - 1;
 
-  // Save the location of the current read pointer.  We will restore the
-  // position using seek() before all returns.
+  // The buffer starts small since the pattern is usually found near the
+  // starting point, and grows for long scans to keep the number of reads low.
 
-  offset_t originalPosition = tell();
+  unsigned int bufferLength = bufferSize();
 
-  // Start the search at the offset.
+  // The position in the file that the current buffer starts at.
+
+  offset_t bufferOffset = fromOffset;
+
+  ByteVector previousTail;
 
   seek(fromOffset);
 
-  // This loop is the crux of the find method.  There are three cases that we
-  // want to account for:
-  //
-  // (1) The previously searched buffer contained a partial match of the search
-  // pattern and we want to see if the next one starts with the remainder of
-  // that pattern.
-  //
-  // (2) The search pattern is wholly contained within the current buffer.
-  //
-  // (3) The current buffer ends with a partial match of the pattern.  We will
-  // note this for use in the next iteration, where we will check for the rest
-  // of the pattern.
-  //
-  // All three of these are done in two steps.  First we check for the pattern
-  // and do things appropriately if a match (or partial match) is found.  We
-  // then check for "before".  The order is important because it gives priority
-  // to "real" matches.
-
-  for(auto buffer = readBlock(bufferSize()); !buffer.isEmpty(); buffer = readBlock(bufferSize())) {
-
-    // (1) previous partial match
-
-    if(previousPartialMatch >= 0 && static_cast<int>(bufferSize()) > previousPartialMatch) {
-      const int patternOffset = (bufferSize() - previousPartialMatch);
-      if(buffer.containsAt(pattern, 0, patternOffset)) {
-        seek(originalPosition);
-        return bufferOffset - bufferSize() + previousPartialMatch;
-      }
-    }
+  for(auto buffer = readBlock(bufferLength); !buffer.isEmpty(); buffer = readBlock(bufferLength)) {
+
+    // (1) pattern spanning the previous and the current buffer
 
-    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && static_cast<int>(bufferSize()) > beforePreviousPartialMatch) {
-      const int beforeOffset = (bufferSize() - beforePreviousPartialMatch);
-      if(buffer.containsAt(before, 0, beforeOffset)) {
+    if(!previousTail.isEmpty()) {
+      const ByteVector boundary = previousTail + buffer.mid(0, overlap);
+      bool stop = false;
+      const offset_t location = findInBuffer(boundary, pattern, before, stop);
+      if(stop || location >= 0) {
         seek(originalPosition);
-        return -1;
+        return stop ? -1 : bufferOffset - previousTail.size() + location;
       }
     }
 
     // (2) pattern contained in current buffer
 
-    long location = buffer.find(pattern);
-    if(location >= 0) {
-      seek(originalPosition);
-      return bufferOffset + location;
-    }
-
-    if(!before.isEmpty() && buffer.find(before) >= 0) {
+    bool stop = false;
+    const offset_t location = findInBuffer(buffer, pattern, before, stop);
+    if(stop || location >= 0) {
       seek(originalPosition);
-      return -1;
+      return stop ? -1 : bufferOffset + location;
     }
 
-    // (3) partial match
-
-    previousPartialMatch = buffer.endsWithPartialMatch(pattern);
-
-    if(!before.isEmpty())
-      beforePreviousPartialMatch = buffer.endsWithPartialMatch(before);
-
-    bufferOffset += bufferSize();
+    previousTail = buffer.mid(buffer.size() - std::min(overlap, buffer.size()));
+    bufferOffset += buffer.size();
+    bufferLength = std::min(bufferLength * 2, maxBufferSize());
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -213,67 +380,66 @@ offset_t File::find(const ByteVector &pattern, offset_t fromOffset, const ByteVe
 
 offset_t File::rfind(const ByteVector &pattern, offset_t fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
+  if(!d->stream || pattern.isEmpty() || pattern.size() > bufferSize())
       return -1;
 
-  // The position in the file that the current buffer starts at.
-
-  ByteVector buffer;
-
-  // These variables are used to keep track of a partial match that happens at
-  // the end of a buffer.
-
-  /*
-  int previousPartialMatch = -1;
-  int beforePreviousPartialMatch = -1;
-  */
-
   // Save the location of the current read pointer.  We will restore the
   // position using seek() before all returns.
 
-  offset_t originalPosition = tell();
+  const offset_t originalPosition = tell();
 
   // Start the search at the offset.
 
   if(fromOffset == 0)
     fromOffset = length();
 
-  offset_t bufferLength = bufferSize();
-  offset_t bufferOffset = fromOffset + pattern.size();
+  // See the notes in find() for an explanation of this algorithm.  Here the
+  // buffers are read backwards, so the tail we keep is the beginning of the
+  // previously read buffer.
 
-  // See the notes in find() for an explanation of this algorithm.
+  const unsigned int overlap = std::max(pattern.size(), before.size()) - 1;
 
-  while(true) {
+  unsigned int bufferLength = bufferSize();
 
-    if(bufferOffset > bufferLength) {
-      bufferOffset -= bufferLength;
-    }
-    else {
-      bufferLength = bufferOffset;
-      bufferOffset = 0;
-    }
-    seek(bufferOffset);
+  // The position in the file that the current buffer ends at.
+
+  offset_t bufferEnd = fromOffset + pattern.size();
+
+  ByteVector previousHead;
 
-    buffer = readBlock(bufferLength);
+  while(bufferEnd > 0) {
+    const offset_t bufferOffset = std::max<offset_t>(bufferEnd - bufferLength, 0);
+
+    seek(bufferOffset);
+    const ByteVector buffer = readBlock(static_cast<size_t>(bufferEnd - bufferOffset));
     if(buffer.isEmpty())
       break;
 
-    // TODO: (1) previous partial match
+    // (1) pattern spanning the current and the previously read buffer
 
-    // (2) pattern contained in current buffer
-
-    const long location = buffer.rfind(pattern);
-    if(location >= 0) {
-      seek(originalPosition);
-      return bufferOffset + location;
+    if(!previousHead.isEmpty()) {
+      const unsigned int headOffset = buffer.size() - std::min(overlap, buffer.size());
+      const ByteVector boundary = buffer.mid(headOffset) + previousHead;
+      bool stop = false;
+      const offset_t location = rfindInBuffer(boundary, pattern, before, stop);
+      if(stop || location >= 0) {
+        seek(originalPosition);
+        return stop ? -1 : bufferOffset + headOffset + location;
+      }
     }
 
-    if(!before.isEmpty() && buffer.find(before) >= 0) {
+    // (2) pattern contained in current buffer
+
+    bool stop = false;
+    const offset_t location = rfindInBuffer(buffer, pattern, before, stop);
+    if(stop || location >= 0) {
       seek(originalPosition);
-      return -1;
+      return stop ? -1 : bufferOffset + location;
     }
 
-    // TODO: (3) partial match
+    previousHead = buffer.mid(0, overlap);
+    bufferEnd = bufferOffset;
+    bufferLength = std::min(bufferLength * 2, maxBufferSize());
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -287,12 +453,41 @@ offset_t File::rfind(const ByteVector &pattern, offset_t fromOffset, const ByteV
 
 void File::insert(const ByteVector &data, offset_t start, size_t replace)
 {
-  d->stream->insert(data, start, replace);
+  if(d->editing)
+    spliceSegments(d->editSegments, d->editLength, data, start, replace);
+  else {
+    d->stream->insert(data, start, replace);
+    d->statistics.insertCalls++;
+    d->statistics.bytesWritten += data.size();
+  }
+}
+
+void File::insertZeros(offset_t length, offset_t start, size_t replace)
+{
+  if(length <= 0) {
+    if(replace > 0)
+      removeBlock(start, replace);
+  }
+  else if(d->editing)
+    spliceSegments(d->editSegments, d->editLength, ByteVector(), start, replace, length);
+  else {
+    // The transaction moves the rest of the file and then writes the zeros
+    // in blocks.
+
+    beginEdit();
+    insertZeros(length, start, replace);
+    commitEdit();
+  }
 }
 
 void File::removeBlock(offset_t start, size_t length)
 {
-  d->stream->removeBlock(start, length);
+  if(d->editing)
+    spliceSegments(d->editSegments, d->editLength, ByteVector(), start, length);
+  else {
+    d->stream->removeBlock(start, length);
+    d->statistics.removeCalls++;
+  }
 }
 
 bool File::readOnly() const
@@ -313,11 +508,24 @@ bool File::isValid() const
 void File::seek(offset_t offset, Position p)
 {
   d->stream->seek(offset, static_cast<IOStream::Position>(p));
+  d->statistics.seekCalls++;
 }
 
 void File::truncate(offset_t length)
 {
-  d->stream->truncate(length);
+  if(d->editing) {
+    if(length < d->editLength)
+      spliceSegments(d->editSegments, d->editLength, ByteVector(), length,
+                     d->editLength - length);
+    else if(length > d->editLength)
+      // Like ftruncate(), extending the file appends zeros.
+      spliceSegments(d->editSegments, d->editLength, ByteVector(), d->editLength, 0,
+                     length - d->editLength);
+  }
+  else {
+    d->stream->truncate(length);
+    d->statistics.truncateCalls++;
+  }
 }
 
 void File::clear()
@@ -332,9 +540,22 @@ offset_t File::tell() const
 
 offset_t File::length()
 {
+  if(d->editing)
+    return d->editLength;
+
   return d->stream->length();
 }
 
+IOStatistics File::ioStatistics() const
+{
+  return d->statistics;
+}
+
+void File::resetIOStatistics()
+{
+  d->statistics = IOStatistics();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected members
 ////////////////////////////////////////////////////////////////////////////////
@@ -348,3 +569,76 @@ void File::setValid(bool valid)
 {
   d->valid = valid;
 }
+
+void File::beginEdit()
+{
+  if(d->editing) {
+    debug("File::beginEdit() -- An edit transaction is already open.");
+    return;
+  }
+
+  d->editLength = d->stream->length();
+  d->editSegments.clear();
+  if(d->editLength > 0)
+    d->editSegments.push_back({ 0, d->editLength, ByteVector() });
+
+  d->editing = true;
+}
+
+void File::commitEdit()
+{
+  if(!d->editing) {
+    debug("File::commitEdit() -- No edit transaction is open.");
+    return;
+  }
+
+  d->editing = false;
+
+  const offset_t originalLength = d->stream->length();
+
+  // Compute the new offset of every segment.
+
+  std::vector<offset_t> offsets;
+  offsets.reserve(d->editSegments.size());
+
+  offset_t offset = 0;
+  for(const auto &segment : d->editSegments) {
+    offsets.push_back(offset);
+    offset += segment.length;
+  }
+
+  // The ranges of the original file keep their order, so moving the ones
+  // which go towards the beginning first in forward order, and then the ones
+  // which go towards the end in backward order never overwrites data which
+  // has not been moved yet.  The new data fills the gaps afterwards.
+
+  for(size_t i = 0; i < d->editSegments.size(); ++i) {
+    const EditSegment &segment = d->editSegments[i];
+    if(segment.sourceOffset >= 0 && offsets[i] < segment.sourceOffset)
+      moveBlock(this, segment.sourceOffset, offsets[i], segment.length);
+  }
+
+  for(size_t i = d->editSegments.size(); i > 0; --i) {
+    const EditSegment &segment = d->editSegments[i - 1];
+    if(segment.sourceOffset >= 0 && offsets[i - 1] > segment.sourceOffset)
+      moveBlock(this, segment.sourceOffset, offsets[i - 1], segment.length);
+  }
+
+  for(size_t i = 0; i < d->editSegments.size(); ++i) {
+    const EditSegment &segment = d->editSegments[i];
+    if(segment.sourceOffset < 0) {
+      seek(offsets[i]);
+      if(segment.data.isEmpty())
+        writeZeros(this, segment.length);
+      else
+        writeBlock(segment.data);
+    }
+  }
+
+  if(d->editLength < originalLength) {
+    d->stream->truncate(d->editLength);
+    d->statistics.truncateCalls++;
+  }
+
+  d->editSegments.clear();
+}
@@ -79,6 +79,17 @@ namespace TagLib {
       DoNotDuplicate //!< Do not synchronize values between different tag types
     };
 
+    /*!
+     * Used to specify the stream through which a file opened by name is
+     * accessed.
+     */
+    enum StreamBackend {
+      //! Read and write the file through a FileStream
+      Buffered,
+      //! Map the file read only through an MMapFileStream
+      MemoryMapped
+    };
+
     /*!
      * Destroys this File instance.
      */
@@ -209,6 +220,16 @@ namespace TagLib {
      */
     void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0);
 
+    /*!
+     * Insert \a length zero bytes at position \a start in the file overwriting
+     * \a replace bytes of the original content.  Unlike insert(), this does
+     * not need all of the new bytes in memory, they are written in blocks.
+     *
+     * \note This method is slow since it requires rewriting all of the file
+     * after the insertion point.
+     */
+    void insertZeros(offset_t length, offset_t start, size_t replace = 0);
+
     /*!
      * Removes a block of the file starting a \a start and continuing for
      * \a length bytes.
@@ -257,6 +278,20 @@ namespace TagLib {
      */
     offset_t length();
 
+    /*!
+     * Returns the counters of the I/O done through this file since it was
+     * opened or resetIOStatistics() was called.  This covers reading the
+     * tags and audio properties and saving, but not the I/O done before the
+     * file was created, e.g. by FileRef to detect the file type.  The time
+     * spent is not measured, use a CountingIOStream for that.
+     */
+    IOStatistics ioStatistics() const;
+
+    /*!
+     * Sets all the counters returned by ioStatistics() to zero.
+     */
+    void resetIOStatistics();
+
   protected:
     /*!
      * Construct a File object and opens the \a file.  \a file should be a
@@ -267,6 +302,16 @@ namespace TagLib {
      */
     File(FileName file);
 
+    /*!
+     * Construct a File object and opens the \a file through the stream
+     * selected by \a backend.  \a file should be a C-string in the local file
+     * system encoding.
+     *
+     * \note Constructor is protected since this class should only be
+     * instantiated through subclasses.
+     */
+    File(FileName file, StreamBackend backend);
+
     /*!
      * Construct a File object and use the \a stream instance.
      *
@@ -295,6 +340,31 @@ namespace TagLib {
      */
     static unsigned int bufferSize();
 
+    /*!
+     * Starts an edit transaction.  Until commitEdit() is called, insert(),
+     * removeBlock() and truncate() only record the changes and length()
+     * returns the length the file will have once they are applied.  This
+     * allows to make several changes with the cost of moving the rest of
+     * the file only once.
+     *
+     * Offsets passed while the transaction is open refer to the file with
+     * all of the previously recorded changes applied.
+     *
+     * \warning readBlock(), writeBlock(), seek() and find() still work on the
+     * unmodified file, so they should not be used in a transaction.
+     *
+     * \see commitEdit()
+     */
+    void beginEdit();
+
+    /*!
+     * Applies the changes recorded since beginEdit() in a single pass over
+     * the file and closes the transaction.
+     *
+     * \see beginEdit()
+     */
+    void commitEdit();
+
   private:
     class FilePrivate;
     std::unique_ptr<FilePrivate> d;
@@ -28,7 +28,9 @@
 #ifdef _WIN32
 # include <windows.h>
 #else
-# include <cstdio>
+# include <cerrno>
+# include <fcntl.h>
+# include <sys/stat.h>
 # include <unistd.h>
 #endif
 
@@ -93,33 +95,66 @@ namespace
     operator FileName () const { return c_str(); }
   };
 
-  using FileHandle = FILE *;
+  // Uses a raw file descriptor with positional I/O, so that reading a block
+  // is a single system call and does not go through the stdio buffers.
 
-  const FileHandle InvalidFileHandle = nullptr;
+  using FileHandle = int;
+
+  const FileHandle InvalidFileHandle = -1;
 
   FileHandle openFile(const FileName &path, bool readOnly)
   {
-    return fopen(path, readOnly ? "rb" : "rb+");
+    return ::open(path, readOnly ? O_RDONLY : O_RDWR);
   }
 
   FileHandle openFile(const int fileDescriptor, bool readOnly)
   {
-    return fdopen(fileDescriptor, readOnly ? "rb" : "rb+");
+    // Like fdopen(), only accept the descriptor if it allows the access mode.
+
+    const int flags = ::fcntl(fileDescriptor, F_GETFL);
+    if(flags == -1)
+      return InvalidFileHandle;
+
+    const int mode = flags & O_ACCMODE;
+    if(mode == O_RDWR || (readOnly && mode == O_RDONLY))
+      return fileDescriptor;
+
+    return InvalidFileHandle;
   }
 
   void closeFile(FileHandle file)
   {
-    fclose(file);
+    ::close(file);
   }
 
-  size_t readFile(FileHandle file, ByteVector &buffer)
+  size_t readFile(FileHandle file, ByteVector &buffer, offset_t position)
   {
-    return fread(buffer.data(), sizeof(char), buffer.size(), file);
+    size_t count = 0;
+    while(count < buffer.size()) {
+      const ssize_t n = ::pread(file, buffer.data() + count, buffer.size() - count,
+                                static_cast<off_t>(position + count));
+      if(n < 0 && errno == EINTR)
+        continue;
+      if(n <= 0)
+        break;
+      count += static_cast<size_t>(n);
+    }
+    return count;
   }
 
-  size_t writeFile(FileHandle file, const ByteVector &buffer)
+  size_t writeFile(FileHandle file, const ByteVector &buffer, offset_t position)
   {
-    return fwrite(buffer.data(), sizeof(char), buffer.size(), file);
+    size_t count = 0;
+    while(count < buffer.size()) {
+      const ssize_t n = ::pwrite(file, buffer.data() + count, buffer.size() - count,
+                                 static_cast<off_t>(position + count));
+      if(n < 0 && errno == EINTR)
+        continue;
+      if(n <= 0)
+        break;
+      count += static_cast<size_t>(n);
+    }
+    return count;
   }
 
 #endif  // _WIN32
@@ -133,9 +168,38 @@ public:
   {
   }
 
+  // Reads or writes at the current position and advances it.
+
+  size_t read(ByteVector &buffer)
+  {
+#ifdef _WIN32
+    return readFile(file, buffer);
+#else
+    const size_t count = readFile(file, buffer, position);
+    position += count;
+    return count;
+#endif
+  }
+
+  size_t write(const ByteVector &buffer)
+  {
+#ifdef _WIN32
+    return writeFile(file, buffer);
+#else
+    const size_t count = writeFile(file, buffer, position);
+    position += count;
+    length = -1;
+    return count;
+#endif
+  }
+
   FileHandle file { InvalidFileHandle };
   FileNameHandle name;
   bool readOnly { true };
+#ifndef _WIN32
+  offset_t position { 0 };
+  offset_t length { -1 };
+#endif
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -178,6 +242,18 @@ FileStream::FileStream(int fileDescriptor, bool openReadOnly) :
 
   if(d->file == InvalidFileHandle)
     debug("Could not open file using file descriptor");
+
+#ifndef _WIN32
+
+  // Start at the current offset of the descriptor, as a stdio stream would.
+
+  if(d->file != InvalidFileHandle) {
+    const off_t position = ::lseek(d->file, 0, SEEK_CUR);
+    if(position > 0)
+      d->position = position;
+  }
+
+#endif
 }
 
 FileStream::~FileStream()
@@ -210,7 +286,7 @@ ByteVector FileStream::readBlock(size_t length)
 
   ByteVector buffer(static_cast<unsigned int>(length));
 
-  const size_t count = readFile(d->file, buffer);
+  const size_t count = d->read(buffer);
   buffer.resize(static_cast<unsigned int>(count));
 
   return buffer;
@@ -228,7 +304,7 @@ void FileStream::writeBlock(const ByteVector &data)
     return;
   }
 
-  writeFile(d->file, data);
+  d->write(data);
 }
 
 void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
@@ -283,7 +359,7 @@ void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
     // to overwrite.  Appropriately increment the readPosition.
 
     seek(readPosition);
-    const auto bytesRead = static_cast<unsigned int>(readFile(d->file, aboutToOverwrite));
+    const auto bytesRead = static_cast<unsigned int>(d->read(aboutToOverwrite));
     aboutToOverwrite.resize(bytesRead);
     readPosition += bufferLength;
 
@@ -328,7 +404,7 @@ void FileStream::removeBlock(offset_t start, size_t length)
 
   for(unsigned int bytesRead = -1; bytesRead != 0;) {
     seek(readPosition);
-    bytesRead = static_cast<unsigned int>(readFile(d->file, buffer));
+    bytesRead = static_cast<unsigned int>(d->read(buffer));
     readPosition += bytesRead;
 
     // Check to see if we just read the last block.  We need to call clear()
@@ -340,7 +416,7 @@ void FileStream::removeBlock(offset_t start, size_t length)
     }
 
     seek(writePosition);
-    writeFile(d->file, buffer);
+    d->write(buffer);
 
     writePosition += bytesRead;
   }
@@ -381,23 +457,31 @@ void FileStream::seek(offset_t offset, Position p)
 
 #else
 
-  int whence;
+  offset_t position;
   switch(p) {
   case Beginning:
-    whence = SEEK_SET;
+    position = offset;
     break;
   case Current:
-    whence = SEEK_CUR;
+    position = d->position + offset;
     break;
   case End:
-    whence = SEEK_END;
+    position = length() + offset;
     break;
   default:
     debug("FileStream::seek() -- Invalid Position value.");
     return;
   }
 
-  fseek(d->file, offset, whence);
+  // Behave like fseek() and leave the position untouched if the new one
+  // would be before the beginning of the file.
+
+  if(position < 0) {
+    debug("FileStream::seek() -- Invalid offset.");
+    return;
+  }
+
+  d->position = position;
 
 #endif
 }
@@ -410,7 +494,7 @@ void FileStream::clear()
 
 #else
 
-  clearerr(d->file);
+  // NOP, positional I/O does not have any end-of-file or error state.
 
 #endif
 }
@@ -431,7 +515,7 @@ offset_t FileStream::tell() const
 
 #else
 
-  return ftell(d->file);
+  return d->position;
 
 #endif
 }
@@ -456,14 +540,16 @@ offset_t FileStream::length()
 
 #else
 
-  const offset_t curpos = tell();
-
-  seek(0, End);
-  const offset_t endpos = tell();
-
-  seek(curpos, Beginning);
+  if(d->length < 0) {
+    struct stat st;
+    if(::fstat(d->file, &st) != 0) {
+      debug("FileStream::length() -- Failed to get the file size.");
+      return 0;
+    }
+    d->length = st.st_size;
+  }
 
-  return endpos;
+  return d->length;
 
 #endif
 }
@@ -488,8 +574,8 @@ void FileStream::truncate(offset_t length)
 
 #else
 
-  fflush(d->file);
-  const int error = ftruncate(fileno(d->file), length);
+  d->length = -1;
+  const int error = ftruncate(d->file, length);
   if(error != 0)
     debug("FileStream::truncate() -- Couldn't truncate the file.");
 
@@ -54,6 +54,34 @@ namespace TagLib {
   using FileName = const char *;
 #endif
 
+  //! Counters of the I/O operations done on a stream or a file
+
+  /*!
+   * \see CountingIOStream, File::ioStatistics()
+   */
+
+  struct IOStatistics
+  {
+    //! Number of bytes returned by readBlock()
+    unsigned long long bytesRead { 0 };
+    //! Number of bytes passed to writeBlock() and insert()
+    unsigned long long bytesWritten { 0 };
+    //! Number of readBlock() calls
+    unsigned long long readCalls { 0 };
+    //! Number of writeBlock() calls
+    unsigned long long writeCalls { 0 };
+    //! Number of seek() calls
+    unsigned long long seekCalls { 0 };
+    //! Number of insert() calls
+    unsigned long long insertCalls { 0 };
+    //! Number of removeBlock() calls
+    unsigned long long removeCalls { 0 };
+    //! Number of truncate() calls
+    unsigned long long truncateCalls { 0 };
+    //! Time spent in the calls in nanoseconds, if measured
+    long long nanoseconds { 0 };
+  };
+
   //! An abstract class that provides operations on a sequence of bytes
 
   class TAGLIB_EXPORT IOStream
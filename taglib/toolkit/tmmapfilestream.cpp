@@ -0,0 +1,276 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tmmapfilestream.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include "tstring.h"
+#include "tdebug.h"
+
+using namespace TagLib;
+
+namespace
+{
+#ifdef _WIN32
+
+  using FileNameHandle = FileName;
+
+  // Maps the whole file and returns the address of the view, or a null pointer
+  // if the file could not be mapped.  An empty file is reported as open with
+  // a null mapping since a zero length view can not be created.
+
+  const char *mapFile(const FileName &path, offset_t &length, bool &opened)
+  {
+#if defined (PLATFORM_WINRT)
+    HANDLE file = CreateFile2(path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, nullptr);
+#else
+    HANDLE file = CreateFileW(path.wstr().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 0, nullptr);
+#endif
+    if(file == INVALID_HANDLE_VALUE)
+      return nullptr;
+
+    const char *data = nullptr;
+
+    LARGE_INTEGER fileSize;
+    if(GetFileSizeEx(file, &fileSize)) {
+      length = fileSize.QuadPart;
+      opened = true;
+
+      if(length > 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(mapping) {
+          data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+          CloseHandle(mapping);
+        }
+        if(!data)
+          opened = false;
+      }
+    }
+
+    CloseHandle(file);
+    return data;
+  }
+
+  void unmapFile(const char *data, offset_t)
+  {
+    UnmapViewOfFile(data);
+  }
+
+#else   // _WIN32
+
+  struct FileNameHandle : public std::string
+  {
+    FileNameHandle(FileName name) : std::string(name) {}
+    operator FileName () const { return c_str(); }
+  };
+
+  const char *mapFile(const FileName &path, offset_t &length, bool &opened)
+  {
+    const int fd = ::open(path, O_RDONLY);
+    if(fd < 0)
+      return nullptr;
+
+    const char *data = nullptr;
+
+    struct stat st;
+    if(::fstat(fd, &st) == 0) {
+      length = st.st_size;
+      opened = true;
+
+      if(length > 0) {
+        void *p = ::mmap(nullptr, static_cast<size_t>(length), PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p != MAP_FAILED)
+          data = static_cast<const char *>(p);
+        else
+          opened = false;
+      }
+    }
+
+    ::close(fd);
+    return data;
+  }
+
+  void unmapFile(const char *data, offset_t length)
+  {
+    ::munmap(const_cast<char *>(data), static_cast<size_t>(length));
+  }
+
+#endif  // _WIN32
+}  // namespace
+
+class MMapFileStream::MMapFileStreamPrivate
+{
+public:
+  MMapFileStreamPrivate(const FileName &fileName) :
+    name(fileName)
+  {
+  }
+
+  ~MMapFileStreamPrivate()
+  {
+    if(data)
+      unmapFile(data, length);
+  }
+
+  MMapFileStreamPrivate(const MMapFileStreamPrivate &) = delete;
+  MMapFileStreamPrivate &operator=(const MMapFileStreamPrivate &) = delete;
+
+  FileNameHandle name;
+  const char *data { nullptr };
+  offset_t length { 0 };
+  offset_t position { 0 };
+  bool opened { false };
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+MMapFileStream::MMapFileStream(FileName fileName) :
+  d(std::make_unique<MMapFileStreamPrivate>(fileName))
+{
+  d->data = mapFile(fileName, d->length, d->opened);
+
+  if(!d->opened)
+# ifdef _WIN32
+    debug("Could not map file " + fileName.toString());
+# else
+    debug("Could not map file " + String(static_cast<const char *>(d->name)));
+# endif
+}
+
+MMapFileStream::~MMapFileStream() = default;
+
+FileName MMapFileStream::name() const
+{
+  return d->name;
+}
+
+ByteVector MMapFileStream::readBlock(size_t length)
+{
+  if(!isOpen()) {
+    debug("MMapFileStream::readBlock() -- invalid file.");
+    return ByteVector();
+  }
+
+  if(length == 0 || d->position >= d->length)
+    return ByteVector();
+
+  // A ByteVector cannot hold 4 GiB or more, so larger reads are clamped
+  // like reads past the end of the file.
+
+  length = static_cast<size_t>(std::min<offset_t>(
+    std::min<size_t>(length, std::numeric_limits<unsigned int>::max()),
+    d->length - d->position));
+
+  ByteVector buffer(d->data + d->position, static_cast<unsigned int>(length));
+  d->position += length;
+
+  return buffer;
+}
+
+void MMapFileStream::writeBlock(const ByteVector &)
+{
+  debug("MMapFileStream::writeBlock() -- read only file.");
+}
+
+void MMapFileStream::insert(const ByteVector &, offset_t, size_t)
+{
+  debug("MMapFileStream::insert() -- read only file.");
+}
+
+void MMapFileStream::removeBlock(offset_t, size_t)
+{
+  debug("MMapFileStream::removeBlock() -- read only file.");
+}
+
+bool MMapFileStream::readOnly() const
+{
+  return true;
+}
+
+bool MMapFileStream::isOpen() const
+{
+  return d->opened;
+}
+
+void MMapFileStream::seek(offset_t offset, Position p)
+{
+  if(!isOpen()) {
+    debug("MMapFileStream::seek() -- invalid file.");
+    return;
+  }
+
+  offset_t position;
+  switch(p) {
+  case Beginning:
+    position = offset;
+    break;
+  case Current:
+    position = d->position + offset;
+    break;
+  case End:
+    position = d->length + offset;
+    break;
+  default:
+    debug("MMapFileStream::seek() -- Invalid Position value.");
+    return;
+  }
+
+  // Behave like fseek() and leave the position untouched if the new one
+  // would be before the beginning of the file.
+
+  if(position < 0) {
+    debug("MMapFileStream::seek() -- Invalid offset.");
+    return;
+  }
+
+  d->position = position;
+}
+
+offset_t MMapFileStream::tell() const
+{
+  return d->position;
+}
+
+offset_t MMapFileStream::length()
+{
+  return d->length;
+}
+
+void MMapFileStream::truncate(offset_t)
+{
+  debug("MMapFileStream::truncate() -- read only file.");
+}
@@ -0,0 +1,140 @@
+/***************************************************************************
+    copyright            : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_MMAPFILESTREAM_H
+#define TAGLIB_MMAPFILESTREAM_H
+
+#include "tbytevector.h"
+#include "tiostream.h"
+#include "taglib_export.h"
+#include "taglib.h"
+
+namespace TagLib {
+
+  //! A read only stream backed by a memory mapping of a file
+
+  /*!
+   * This stream maps the whole file into memory and serves readBlock() by
+   * copying straight out of the mapping, so reading does not involve any
+   * seek or read system calls.  This is useful for scanning large numbers
+   * of files when only the tags and audio properties are needed.
+   *
+   * The stream is always read only.  Pass it to one of the File constructors
+   * taking an IOStream, or to FileRef(IOStream *), to use it:
+   *
+   * \code
+   * TagLib::MMapFileStream stream("song.mp3");
+   * TagLib::FileRef f(&stream);
+   * \endcode
+   *
+   * or let FileRef open it by passing File::MemoryMapped to
+   * FileRef(FileName, bool, AudioProperties::ReadStyle, File::StreamBackend).
+   *
+   * \warning If the file is truncated by another process while it is mapped,
+   * accessing the missing part may terminate the process with a bus error.
+   */
+
+  class TAGLIB_EXPORT MMapFileStream : public IOStream
+  {
+  public:
+    /*!
+     * Opens and maps the \a file.  \a file should be a C-string in the local
+     * file system encoding.
+     */
+    MMapFileStream(FileName file);
+
+    /*!
+     * Destroys this MMapFileStream instance and unmaps the file.
+     */
+    ~MMapFileStream() override;
+
+    MMapFileStream(const MMapFileStream &) = delete;
+    MMapFileStream &operator=(const MMapFileStream &) = delete;
+
+    /*!
+     * Returns the file name in the local file system encoding.
+     */
+    FileName name() const override;
+
+    /*!
+     * Reads a block of size \a length at the current get pointer.
+     */
+    ByteVector readBlock(size_t length) override;
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void writeBlock(const ByteVector &data) override;
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+
+    /*!
+     * Always returns true.
+     */
+    bool readOnly() const override;
+
+    /*!
+     * Returns true if the file could be opened and mapped.
+     */
+    bool isOpen() const override;
+
+    /*!
+     * Move the I/O pointer to \a offset in the file from position \a p.  This
+     * defaults to seeking from the beginning of the file.
+     *
+     * \see Position
+     */
+    void seek(offset_t offset, Position p = Beginning) override;
+
+    /*!
+     * Returns the current offset within the file.
+     */
+    offset_t tell() const override;
+
+    /*!
+     * Returns the length of the file.
+     */
+    offset_t length() override;
+
+    /*!
+     * Does nothing, since the stream is read only.
+     */
+    void truncate(offset_t length) override;
+
+  private:
+    class MMapFileStreamPrivate;
+    std::unique_ptr<MMapFileStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
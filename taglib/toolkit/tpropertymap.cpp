@@ -27,6 +27,8 @@
 
 #include <utility>
 
+#include "tagutils.h"
+
 using namespace TagLib;
 
 class PropertyMap::PropertyMapPrivate
@@ -63,7 +65,7 @@ PropertyMap::~PropertyMap() = default;
 
 bool PropertyMap::insert(const String &key, const StringList &values)
 {
-  String realKey = key.upper();
+  String realKey = Utils::internKey(key.upper());
   auto result = SimplePropertyMap::find(realKey);
   if(result == end())
     SimplePropertyMap::insert(realKey, values);
@@ -74,7 +76,7 @@ bool PropertyMap::insert(const String &key, const StringList &values)
 
 bool PropertyMap::replace(const String &key, const StringList &values)
 {
-  String realKey = key.upper();
+  String realKey = Utils::internKey(key.upper());
   SimplePropertyMap::erase(realKey);
   SimplePropertyMap::insert(realKey, values);
   return true;
@@ -25,8 +25,12 @@
 
 #include "tstring.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
+#include <cstring>
+#include <type_traits>
 #include <utf8.h>
 
 #include "tdebug.h"
@@ -45,6 +49,28 @@ namespace
     return String::UTF16BE;
   }
 
+  // Returns the number of ASCII characters at the beginning of the 8-bit
+  // string.  Tags are mostly ASCII, so eight bytes are checked at a time.
+  size_t asciiPrefixLength(const char *s, size_t length)
+  {
+    size_t i = 0;
+    for(; i + 8 <= length; i += 8) {
+      unsigned long long word;
+      ::memcpy(&word, s + i, 8);
+      if(word & 0x8080808080808080ULL)
+        break;
+    }
+    while(i < length && static_cast<unsigned char>(s[i]) < 0x80)
+      ++i;
+    return i;
+  }
+
+  // Returns true if the 8-bit string contains only ASCII characters.
+  bool isAsciiData(const char *s, size_t length)
+  {
+    return asciiPrefixLength(s, length) == length;
+  }
+
   // Converts a Latin-1 string into UTF-16(without BOM/CPU byte order)
   // and copies it to the internal buffer.
   void copyFromLatin1(std::wstring &data, const char *s, size_t length)
@@ -61,8 +87,14 @@ namespace
   {
     data.resize(length);
 
+    // Copy the ASCII part directly and only decode the rest.
+
+    const size_t ascii = asciiPrefixLength(s, length);
+    std::copy(s, s + ascii, data.begin());
+
     try {
-      const std::wstring::iterator dstEnd = utf8::utf8to16(s, s + length, data.begin());
+      const std::wstring::iterator dstEnd =
+        utf8::utf8to16(s + ascii, s + length, data.begin() + ascii);
       data.resize(dstEnd - data.begin());
     }
     catch(const utf8::exception &e) {
@@ -72,6 +104,14 @@ namespace
     }
   }
 
+  // Returns true if the Latin-1 string and the UTF-16 string are equal.
+  bool equals(const std::string &latin1, const std::wstring &wide)
+  {
+    return latin1.size() == wide.size() &&
+      std::equal(latin1.begin(), latin1.end(), wide.begin(),
+                 [](char c, wchar_t w) { return static_cast<unsigned char>(c) == w; });
+  }
+
   // Helper functions to read a UTF-16 character from an array.
   template <typename T>
   unsigned short nextUTF16(const T **p);
@@ -131,22 +171,278 @@ namespace
         data[i] = c;
     }
   }
+
+  // Returns the character value of a Latin-1 or UTF-16 code unit.
+  unsigned int codeUnit(char c)
+  {
+    return static_cast<unsigned char>(c);
+  }
+
+  unsigned int codeUnit(wchar_t c)
+  {
+    return static_cast<unsigned int>(c);
+  }
+
+  // Converts the Latin-1 or UTF-16 internal buffer into the encoding t.
+  template <typename T>
+  ByteVector encode(const T &s, String::Type t)
+  {
+    const auto size = static_cast<unsigned int>(s.size());
+
+    switch(t)
+    {
+    case String::Latin1:
+      {
+        ByteVector v(size, 0);
+        char *p = v.data();
+
+        for(auto c : s) {
+          *p++ = static_cast<char>(codeUnit(c));
+        }
+
+        return v;
+      }
+    case String::UTF8:
+      {
+        if constexpr(std::is_same_v<T, std::string>) {
+          ByteVector v(size * 2, 0);
+          char *p = v.data();
+
+          for(auto c : s) {
+            const unsigned int u = codeUnit(c);
+            if(u < 0x80) {
+              *p++ = static_cast<char>(u);
+            }
+            else {
+              *p++ = static_cast<char>(0xc0 | (u >> 6));
+              *p++ = static_cast<char>(0x80 | (u & 0x3f));
+            }
+          }
+
+          v.resize(static_cast<unsigned int>(p - v.data()));
+          return v;
+        }
+        else {
+          ByteVector v(size * 4, 0);
+
+          // Copy the ASCII part directly and only encode the rest.
+
+          auto src = s.begin();
+          auto dst = v.begin();
+          for(; src != s.end() && codeUnit(*src) < 0x80; ++src, ++dst)
+            *dst = static_cast<char>(*src);
+
+          try {
+            const auto dstEnd = utf8::utf16to8(src, s.end(), dst);
+            v.resize(static_cast<unsigned int>(dstEnd - v.begin()));
+          }
+          catch(const utf8::exception &e) {
+            const String message(e.what());
+            debug("String::data() - UTF8-CPP error: " + message);
+            v.clear();
+          }
+
+          return v;
+        }
+      }
+    case String::UTF16:
+      {
+        ByteVector v(2 + size * 2, 0);
+        char *p = v.data();
+
+        // We use little-endian encoding here and need a BOM.
+
+        *p++ = '\xff';
+        *p++ = '\xfe';
+
+        for(auto c : s) {
+          *p++ = static_cast<char>(codeUnit(c) & 0xff);
+          *p++ = static_cast<char>(codeUnit(c) >> 8);
+        }
+
+        return v;
+      }
+    case String::UTF16BE:
+      {
+        ByteVector v(size * 2, 0);
+        char *p = v.data();
+
+        for(auto c : s) {
+          *p++ = static_cast<char>(codeUnit(c) >> 8);
+          *p++ = static_cast<char>(codeUnit(c) & 0xff);
+        }
+
+        return v;
+      }
+    case String::UTF16LE:
+      {
+        ByteVector v(size * 2, 0);
+        char *p = v.data();
+
+        for(auto c : s) {
+          *p++ = static_cast<char>(codeUnit(c) & 0xff);
+          *p++ = static_cast<char>(codeUnit(c) >> 8);
+        }
+
+        return v;
+      }
+    default:
+      {
+        debug("String::data() - Invalid Type value.");
+        return ByteVector();
+      }
+    }
+  }
 }  // namespace
 
 namespace TagLib {
 
-  class String::StringPrivate
+class String::StringPrivate
+{
+public:
+  StringPrivate() = default;
+
+  ~StringPrivate()
   {
-  public:
-    /*!
-     * Stores string in UTF-16. The byte order depends on the CPU endian.
-     */
-    TagLib::wstring data;
+    delete wide.load();
+    clearCStrings();
+  }
+
+  StringPrivate(const StringPrivate &) = delete;
+  StringPrivate &operator=(const StringPrivate &) = delete;
+
+  /*!
+   * Returns the string in UTF-16.  For a compact string the UTF-16 copy is
+   * created on first use, this is safe even if several threads share the data.
+   */
+  const TagLib::wstring &wstr() const
+  {
+    TagLib::wstring *w = wide.load(std::memory_order_acquire);
+    if(!w) {
+      auto created = new TagLib::wstring;
+      copyFromLatin1(*created, latin1.data(), latin1.size());
+      if(wide.compare_exchange_strong(w, created, std::memory_order_acq_rel))
+        w = created;
+      else
+        delete created;
+    }
+    return *w;
+  }
+
+  /*!
+   * Returns the 8-bit copy for toCString(), in UTF-8 if \a unicode is true,
+   * which is created with \a create on first use.  Like wstr(), this is safe
+   * even if several threads share the data.
+   */
+  template <typename Create>
+  const std::string &cstr(bool unicode, Create create) const
+  {
+    std::atomic<std::string *> &cache = cstring[unicode ? 1 : 0];
+    std::string *c = cache.load(std::memory_order_acquire);
+    if(!c) {
+      auto created = new std::string(create());
+      if(cache.compare_exchange_strong(c, created, std::memory_order_acq_rel))
+        c = created;
+      else
+        delete created;
+    }
+    return *c;
+  }
+
+  /*!
+   * Drops the copies made by toCString().  The data must not be shared.
+   */
+  void clearCStrings()
+  {
+    delete cstring[0].exchange(nullptr);
+    delete cstring[1].exchange(nullptr);
+  }
+
+  /*!
+   * Switches to UTF-16 storage to allow modifications through iterators and
+   * references.  The data must not be shared.
+   */
+  TagLib::wstring &mutableWstr()
+  {
+    clearCStrings();
+    if(compact) {
+      wstr();
+      compact = false;
+      std::string().swap(latin1);
+    }
+    return *wide.load();
+  }
 
-    /*!
-     * This is only used to hold the the most recent value of toCString().
-     */
-    std::string cstring;
+  /*!
+   * Returns the Latin-1 storage for modification, dropping the UTF-16 cache.
+   * The data must not be shared and be compact.
+   */
+  std::string &mutableLatin1()
+  {
+    clearCStrings();
+    delete wide.exchange(nullptr);
+    return latin1;
+  }
+
+  /*!
+   * Replaces the contents with \a s, using the compact storage if all of its
+   * characters are in Latin-1.
+   */
+  void setWstr(TagLib::wstring &&s)
+  {
+    clearCStrings();
+    if(std::all_of(s.begin(), s.end(), [](wchar_t c) { return c < 256; })) {
+      latin1.assign(s.begin(), s.end());
+      compact = true;
+      delete wide.exchange(nullptr);
+    }
+    else {
+      std::string().swap(latin1);
+      compact = false;
+      delete wide.exchange(new TagLib::wstring(std::move(s)));
+    }
+  }
+
+  /*!
+   * Replaces the contents with the UTF-8 string \a s.  Plain ASCII is stored
+   * as it is without decoding.
+   */
+  void setUTF8(const char *s, size_t length)
+  {
+    if(isAsciiData(s, length)) {
+      clearCStrings();
+      latin1.assign(s, length);
+      compact = true;
+      delete wide.exchange(nullptr);
+    }
+    else {
+      TagLib::wstring w;
+      copyFromUTF8(w, s, length);
+      setWstr(std::move(w));
+    }
+  }
+
+  /*!
+   * Stores the string in Latin-1 if \a compact is true.  Most tags only
+   * contain ASCII, for which this takes a quarter of the memory of UTF-16 on
+   * platforms with a 32-bit wchar_t.
+   */
+  std::string latin1;
+
+  /*!
+   * Stores the string in UTF-16.  The byte order depends on the CPU endian.
+   * If \a compact is true, this is a cache of \a latin1 or null.
+   */
+  mutable std::atomic<TagLib::wstring *> wide { nullptr };
+
+  bool compact { true };
+
+  /*!
+   * Holds the values of toCString() in Latin-1 and UTF-8, created on first
+   * use.  They are never replaced while the data is shared, so the pointers
+   * handed out stay valid.
+   */
+  mutable std::atomic<std::string *> cstring[2] { { nullptr }, { nullptr } };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -164,9 +460,9 @@ String::String(const std::string &s, Type t) :
   d(std::make_shared<StringPrivate>())
 {
   if(t == Latin1)
-    copyFromLatin1(d->data, s.c_str(), s.length());
+    d->latin1 = s;
   else if(t == String::UTF8)
-    copyFromUTF8(d->data, s.c_str(), s.length());
+    d->setUTF8(s.c_str(), s.length());
   else {
     debug("String::String() -- std::string should not contain UTF16.");
   }
@@ -183,7 +479,9 @@ String::String(const wstring &s, Type t) :
     else if (t == UTF16LE)
       t = (wcharByteOrder() == UTF16LE ? UTF16BE : UTF16LE);
 
-    copyFromUTF16(d->data, s.c_str(), s.length(), t);
+    TagLib::wstring data;
+    copyFromUTF16(data, s.c_str(), s.length(), t);
+    d->setWstr(std::move(data));
   }
   else {
     debug("String::String() -- TagLib::wstring should not contain Latin1 or UTF-8.");
@@ -201,7 +499,9 @@ String::String(const wchar_t *s, Type t) :
     else if (t == UTF16LE)
       t = (wcharByteOrder() == UTF16LE ? UTF16BE : UTF16LE);
 
-    copyFromUTF16(d->data, s, ::wcslen(s), t);
+    TagLib::wstring data;
+    copyFromUTF16(data, s, ::wcslen(s), t);
+    d->setWstr(std::move(data));
   }
   else {
     debug("String::String() -- const wchar_t * should not contain Latin1 or UTF-8.");
@@ -212,9 +512,9 @@ String::String(const char *s, Type t) :
   d(std::make_shared<StringPrivate>())
 {
   if(t == Latin1)
-    copyFromLatin1(d->data, s, ::strlen(s));
+    d->latin1 = s;
   else if(t == String::UTF8)
-    copyFromUTF8(d->data, s, ::strlen(s));
+    d->setUTF8(s, ::strlen(s));
   else {
     debug("String::String() -- const char * should not contain UTF16.");
   }
@@ -223,8 +523,11 @@ String::String(const char *s, Type t) :
 String::String(wchar_t c, Type t) :
   d(std::make_shared<StringPrivate>())
 {
-  if(t == UTF16 || t == UTF16BE || t == UTF16LE)
-    copyFromUTF16(d->data, &c, 1, t);
+  if(t == UTF16 || t == UTF16BE || t == UTF16LE) {
+    TagLib::wstring data;
+    copyFromUTF16(data, &c, 1, t);
+    d->setWstr(std::move(data));
+  }
   else {
     debug("String::String() -- wchar_t should not contain Latin1 or UTF-8.");
   }
@@ -234,9 +537,9 @@ String::String(char c, Type t) :
   d(std::make_shared<StringPrivate>())
 {
   if(t == Latin1)
-    copyFromLatin1(d->data, &c, 1);
+    d->latin1.assign(1, c);
   else if(t == String::UTF8)
-    copyFromUTF8(d->data, &c, 1);
+    d->setUTF8(&c, 1);
   else {
     debug("String::String() -- char should not contain UTF16.");
   }
@@ -248,15 +551,18 @@ String::String(const ByteVector &v, Type t) :
   if(v.isEmpty())
     return;
 
+  // If we hit a null in the ByteVector, shrink the string again.
+
   if(t == Latin1)
-    copyFromLatin1(d->data, v.data(), v.size());
+    d->latin1.assign(v.data(), ::strnlen(v.data(), v.size()));
   else if(t == UTF8)
-    copyFromUTF8(d->data, v.data(), v.size());
-  else
-    copyFromUTF16(d->data, v.data(), v.size() / 2, t);
-
-  // If we hit a null in the ByteVector, shrink the string again.
-  d->data.resize(::wcslen(d->data.c_str()));
+    d->setUTF8(v.data(), ::strnlen(v.data(), v.size()));
+  else {
+    TagLib::wstring data;
+    copyFromUTF16(data, v.data(), v.size() / 2, t);
+    data.resize(::wcslen(data.c_str()));
+    d->setWstr(std::move(data));
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -265,66 +571,77 @@ String::~String() = default;
 
 std::string String::to8Bit(bool unicode) const
 {
+  if(d->compact && (!unicode || isAsciiData(d->latin1.data(), d->latin1.size())))
+    return d->latin1;
+
   const ByteVector v = data(unicode ? UTF8 : Latin1);
   return std::string(v.data(), v.size());
 }
 
 TagLib::wstring String::toWString() const
 {
-  return d->data;
+  return d->wstr();
 }
 
 const char *String::toCString(bool unicode) const
 {
-  d->cstring = to8Bit(unicode);
-  return d->cstring.c_str();
+  if(d->compact && (!unicode || isAsciiData(d->latin1.data(), d->latin1.size())))
+    return d->latin1.c_str();
+
+  return d->cstr(unicode, [&] { return to8Bit(unicode); }).c_str();
 }
 
 const wchar_t *String::toCWString() const
 {
-  return d->data.c_str();
+  return d->wstr().c_str();
 }
 
 String::Iterator String::begin()
 {
   detach();
-  return d->data.begin();
+  return d->mutableWstr().begin();
 }
 
 String::ConstIterator String::begin() const
 {
-  return d->data.begin();
+  return d->wstr().begin();
 }
 
 String::ConstIterator String::cbegin() const
 {
-  return d->data.cbegin();
+  return d->wstr().cbegin();
 }
 
 String::Iterator String::end()
 {
   detach();
-  return d->data.end();
+  return d->mutableWstr().end();
 }
 
 String::ConstIterator String::end() const
 {
-  return d->data.end();
+  return d->wstr().end();
 }
 
 String::ConstIterator String::cend() const
 {
-  return d->data.cend();
+  return d->wstr().cend();
 }
 
 int String::find(const String &s, int offset) const
 {
-  return static_cast<int>(d->data.find(s.d->data, offset));
+  if(d->compact && s.d->compact)
+    return static_cast<int>(d->latin1.find(s.d->latin1, offset));
+
+  return static_cast<int>(d->wstr().find(s.d->wstr(), offset));
 }
 
 int String::rfind(const String &s, int offset) const
 {
-  return static_cast<int>(d->data.rfind(s.d->data, offset));
+  if(d->compact && s.d->compact)
+    return static_cast<int>(d->latin1.rfind(s.d->latin1, offset));
+
+  return static_cast<int>(d->wstr().rfind(s.d->wstr(), offset));
 }
 
 StringList String::split(const String &separator) const
@@ -354,13 +671,23 @@ String String::substr(unsigned int position, unsigned int n) const
 {
   if(position == 0 && n >= size())
     return *this;
-  return String(d->data.substr(position, n));
+
+  String s;
+  if(d->compact)
+    s.d->latin1 = d->latin1.substr(position, n);
+  else
+    s.d->setWstr(d->wstr().substr(position, n));
+  return s;
 }
 
 String &String::append(const String &s)
 {
   detach();
-  d->data += s.d->data;
+
+  if(d->compact && s.d->compact)
+    d->mutableLatin1() += s.d->latin1;
+  else
+    d->mutableWstr() += s.d->wstr();
   return *this;
 }
 
@@ -372,14 +699,32 @@ String & String::clear()
 
 String String::upper() const
 {
+  // Keys are usually upper case already, share the data in this case.
+
+  const auto isLower = [](auto c) { return c >= 'a' && c <= 'z'; };
+  if(d->compact ? std::none_of(d->latin1.begin(), d->latin1.end(), isLower)
+                : std::none_of(d->wstr().begin(), d->wstr().end(), isLower))
+    return *this;
+
   String s;
-  s.d->data.reserve(size());
+
+  if(d->compact) {
+    s.d->latin1 = d->latin1;
+    for(char &c : s.d->latin1) {
+      if(c >= 'a' && c <= 'z')
+        c = static_cast<char>(c + 'A' - 'a');
+    }
+    return s;
+  }
+
+  TagLib::wstring &data = s.d->mutableWstr();
+  data.reserve(size());
 
   for(wchar_t c : *this) {
     if(c >= 'a' && c <= 'z')
-      s.d->data.push_back(c + 'A' - 'a');
+      data.push_back(c + 'A' - 'a');
     else
-      s.d->data.push_back(c);
+      data.push_back(c);
   }
 
   return s;
@@ -387,7 +732,10 @@ String String::upper() const
 
 unsigned int String::size() const
 {
-  return static_cast<unsigned int>(d->data.size());
+  if(d->compact)
+    return static_cast<unsigned int>(d->latin1.size());
+
+  return static_cast<unsigned int>(d->wstr().size());
 }
 
 unsigned int String::length() const
@@ -397,92 +745,20 @@ unsigned int String::length() const
 
 bool String::isEmpty() const
 {
-  return d->data.empty();
+  return size() == 0;
 }
 
 ByteVector String::data(Type t) const
 {
-  switch(t)
-  {
-  case Latin1:
-    {
-      ByteVector v(size(), 0);
-      char *p = v.data();
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c);
-      }
+  if(d->compact)
+    return encode(d->latin1, t);
 
-      return v;
-    }
-  case UTF8:
-    {
-      ByteVector v(size() * 4, 0);
-
-      try {
-        const auto dstEnd = utf8::utf16to8(begin(), end(), v.begin());
-        v.resize(static_cast<unsigned int>(dstEnd - v.begin()));
-      }
-      catch(const utf8::exception &e) {
-        const String message(e.what());
-        debug("String::data() - UTF8-CPP error: " + message);
-        v.clear();
-      }
-
-      return v;
-    }
-  case UTF16:
-    {
-      ByteVector v(2 + size() * 2, 0);
-      char *p = v.data();
-
-      // We use little-endian encoding here and need a BOM.
-
-      *p++ = '\xff';
-      *p++ = '\xfe';
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c & 0xff);
-        *p++ = static_cast<char>(c >> 8);
-      }
-
-      return v;
-    }
-  case UTF16BE:
-    {
-      ByteVector v(size() * 2, 0);
-      char *p = v.data();
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c >> 8);
-        *p++ = static_cast<char>(c & 0xff);
-      }
-
-      return v;
-    }
-  case UTF16LE:
-    {
-      ByteVector v(size() * 2, 0);
-      char *p = v.data();
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c & 0xff);
-        *p++ = static_cast<char>(c >> 8);
-      }
-
-      return v;
-    }
-  default:
-    {
-      debug("String::data() - Invalid Type value.");
-      return ByteVector();
-    }
-  }
+  return encode(d->wstr(), t);
 }
 
 int String::toInt(bool *ok) const
 {
-  const wchar_t *begin = d->data.c_str();
+  const wchar_t *begin = toCWString();
   wchar_t *end;
   errno = 0;
   const long value = ::wcstol(begin, &end, 10);
@@ -500,21 +776,36 @@ String String::stripWhiteSpace() const
 {
   static const wchar_t *WhiteSpaceChars = L"\t\n\f\r ";
 
-  const size_t pos1 = d->data.find_first_not_of(WhiteSpaceChars);
-  if(pos1 == std::wstring::npos)
+  size_t pos1;
+  size_t pos2;
+  if(d->compact) {
+    pos1 = d->latin1.find_first_not_of("\t\n\f\r ");
+    pos2 = d->latin1.find_last_not_of("\t\n\f\r ");
+  }
+  else {
+    pos1 = d->wstr().find_first_not_of(WhiteSpaceChars);
+    pos2 = d->wstr().find_last_not_of(WhiteSpaceChars);
+  }
+
+  if(pos1 == std::string::npos)
     return String();
 
-  const size_t pos2 = d->data.find_last_not_of(WhiteSpaceChars);
   return substr(static_cast<unsigned int>(pos1), static_cast<unsigned int>(pos2 - pos1 + 1));
 }
 
 bool String::isLatin1() const
 {
+  if(d->compact)
+    return true;
+
   return std::none_of(this->begin(), this->end(), [](auto c) { return c >= 256; });
 }
 
 bool String::isAscii() const
 {
+  if(d->compact)
+    return isAsciiData(d->latin1.data(), d->latin1.size());
+
   return std::none_of(this->begin(), this->end(), [](auto c) { return c >= 128; });
 }
 
@@ -526,17 +817,29 @@ String String::number(int n) // static
 wchar_t &String::operator[](int i)
 {
   detach();
-  return d->data[i];
+  return d->mutableWstr()[i];
 }
 
 const wchar_t &String::operator[](int i) const
 {
-  return d->data[i];
+  return d->wstr()[i];
 }
 
 bool String::operator==(const String &s) const
 {
-  return (d == s.d || d->data == s.d->data);
+  if(d == s.d)
+    return true;
+
+  if(d->compact && s.d->compact)
+    return d->latin1 == s.d->latin1;
+
+  if(d->compact)
+    return equals(d->latin1, s.d->wstr());
+
+  if(s.d->compact)
+    return equals(s.d->latin1, d->wstr());
+
+  return d->wstr() == s.d->wstr();
 }
 
 bool String::operator!=(const String &s) const
@@ -546,6 +849,9 @@ bool String::operator!=(const String &s) const
 
 bool String::operator==(const char *s) const
 {
+  if(d->compact)
+    return ::strcmp(d->latin1.c_str(), s) == 0;
+
   const wchar_t *p = toCWString();
 
   while(*p != L'\0' || *s != '\0') {
@@ -562,7 +868,10 @@ bool String::operator!=(const char *s) const
 
 bool String::operator==(const wchar_t *s) const
 {
-  return (d->data == s);
+  if(d->compact)
+    return equals(d->latin1, TagLib::wstring(s));
+
+  return (d->wstr() == s);
 }
 
 bool String::operator!=(const wchar_t *s) const
@@ -572,17 +881,20 @@ bool String::operator!=(const wchar_t *s) const
 
 String &String::operator+=(const String &s)
 {
-  detach();
-
-  d->data += s.d->data;
-  return *this;
+  return append(s);
 }
 
 String &String::operator+=(const wchar_t *s)
 {
   detach();
 
-  d->data += s;
+  if(d->compact && std::all_of(s, s + ::wcslen(s), [](wchar_t c) { return c < 256; })) {
+    std::string &data = d->mutableLatin1();
+    for(int i = 0; s[i] != 0; i++)
+      data += static_cast<char>(s[i]);
+  }
+  else
+    d->mutableWstr() += s;
   return *this;
 }
 
@@ -590,8 +902,13 @@ String &String::operator+=(const char *s)
 {
   detach();
 
-  for(int i = 0; s[i] != 0; i++)
-    d->data += static_cast<unsigned char>(s[i]);
+  if(d->compact)
+    d->mutableLatin1() += s;
+  else {
+    TagLib::wstring &data = d->mutableWstr();
+    for(int i = 0; s[i] != 0; i++)
+      data += static_cast<unsigned char>(s[i]);
+  }
   return *this;
 }
 
@@ -599,7 +916,10 @@ String &String::operator+=(wchar_t c)
 {
   detach();
 
-  d->data += c;
+  if(d->compact && c < 256)
+    d->mutableLatin1() += static_cast<char>(c);
+  else
+    d->mutableWstr() += c;
   return *this;
 }
 
@@ -607,7 +927,10 @@ String &String::operator+=(char c)
 {
   detach();
 
-  d->data += static_cast<unsigned char>(c);
+  if(d->compact)
+    d->mutableLatin1() += c;
+  else
+    d->mutableWstr() += static_cast<unsigned char>(c);
   return *this;
 }
 
@@ -664,7 +987,13 @@ void String::swap(String &s)
 
 bool String::operator<(const String &s) const
 {
-  return (d->data < s.d->data);
+  if(d == s.d)
+    return false;
+
+  if(d->compact && s.d->compact)
+    return d->latin1 < s.d->latin1;
+
+  return (d->wstr() < s.d->wstr());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -673,8 +1002,14 @@ bool String::operator<(const String &s) const
 
 void String::detach()
 {
-  if(d.use_count() > 1)
-    String(d->data.c_str()).swap(*this);
+  if(d.use_count() > 1) {
+    auto copy = std::make_shared<StringPrivate>();
+    if(d->compact)
+      copy->latin1 = d->latin1;
+    else
+      copy->setWstr(TagLib::wstring(d->wstr()));
+    d = copy;
+  }
 }
 
 }  // namespace TagLib
@@ -67,10 +67,13 @@ namespace TagLib {
   //! A \e wide string class suitable for unicode.
 
   /*!
-   * This is an implicitly shared \e wide string.  For storage it uses
-   * TagLib::wstring, but as this is an <i>implementation detail</i> this of
-   * course could change.  Strings are stored internally as UTF-16(without BOM/
-   * CPU byte order)
+   * This is an implicitly shared \e wide string.  Strings which only contain
+   * Latin1 characters are stored compactly in 8 bits per character, others
+   * are stored internally as UTF-16(without BOM/CPU byte order) in a
+   * TagLib::wstring.  A UTF-16 copy of a compact string is created on demand
+   * when the wide characters are accessed, e.g. by toCWString() or the
+   * iterators.  As this is an <i>implementation detail</i> this of course
+   * could change.
    *
    * The use of implicit sharing means that copying a string is cheap, the only
    * \e cost comes into play when the copy is modified.  Prior to that the string
@@ -235,8 +238,8 @@ namespace TagLib {
      * The returned pointer remains valid until this String instance is destroyed
      * or any other method of this String is called.
      *
-     * \note This returns a pointer to the String's internal data without any
-     * conversions.
+     * \note This returns a pointer to the String's internal data, which is
+     * converted from the compact storage only on the first call.
      *
      * \see toWString()
      */
@@ -56,6 +56,7 @@ public:
   long ID3v2OriginalSize { 0 };
 
   offset_t ID3v1Location { -1 };
+  bool headOnly { false };
 
   TagUnion tag;
 
@@ -67,49 +68,53 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool TrueAudio::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 3, true));
+}
+
+bool TrueAudio::File::isSupported(const ByteVector &data)
 {
   // A TrueAudio file has to start with "TTA". An ID3v2 tag may precede.
 
-  const ByteVector id = Utils::readHeader(stream, 3, true);
-  return (id == "TTA");
+  return (data.startsWith("TTA"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-TrueAudio::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+TrueAudio::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 TrueAudio::File::File(FileName file, ID3v2::FrameFactory *frameFactory,
-                      bool readProperties, Properties::ReadStyle) :
+                      bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-TrueAudio::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+TrueAudio::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 TrueAudio::File::File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
-                      bool readProperties, Properties::ReadStyle) :
+                      bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>(frameFactory))
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 TrueAudio::File::~File() = default;
@@ -149,6 +154,11 @@ bool TrueAudio::File::save()
     return false;
   }
 
+  if(d->headOnly) {
+    debug("TrueAudio::File::save() -- Cannot save a file opened with HeadOnly.");
+    return false;
+  }
+
   // Update ID3v2 tag
 
   if(ID3v2Tag() && !ID3v2Tag()->isEmpty()) {
@@ -246,7 +256,7 @@ bool TrueAudio::File::hasID3v2Tag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void TrueAudio::File::read(bool readProperties)
+void TrueAudio::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v2 tag
 
@@ -257,9 +267,11 @@ void TrueAudio::File::read(bool readProperties)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
-  // Look for an ID3v1 tag
+  // Look for an ID3v1 tag.  With HeadOnly, the end of the file is only read
+  // if there is no ID3v2 tag at the beginning.
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  d->headOnly = (propertiesStyle == Properties::HeadOnly && d->ID3v2Location >= 0);
+  d->ID3v1Location = d->headOnly ? -1 : Utils::findID3v1(this);
 
   if(d->ID3v1Location >= 0)
     d->tag.set(TrueAudioID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
@@ -269,7 +281,7 @@ void TrueAudio::File::read(bool readProperties)
 
   // Look for TrueAudio metadata
 
-  if(readProperties) {
+  if(readProperties && propertiesStyle != Properties::HeadOnly) {
 
     offset_t streamLength;
 
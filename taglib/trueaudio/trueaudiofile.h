@@ -82,7 +82,8 @@ namespace TagLib {
        * Constructs a TrueAudio file from \a file.  If \a readProperties is true
        * the file's audio properties will also be read.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(FileName file, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -94,7 +95,8 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(FileName file, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
@@ -107,7 +109,8 @@ namespace TagLib {
        * \note TagLib will *not* take ownership of the stream, the caller is
        * responsible for deleting it after the File object.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(IOStream *stream, bool readProperties = true,
            Properties::ReadStyle propertiesStyle = Properties::Average);
@@ -122,7 +125,8 @@ namespace TagLib {
        * If this file contains and ID3v2 tag the frames will be created using
        * \a frameFactory.
        *
-       * \note In the current implementation, \a propertiesStyle is ignored.
+       * \note In the current implementation, \a propertiesStyle is ignored
+       * except for Properties::HeadOnly.
        */
       File(IOStream *stream, ID3v2::FrameFactory *frameFactory,
            bool readProperties = true,
@@ -239,8 +243,16 @@ namespace TagLib {
        */
       static bool isSupported(IOStream *stream);
 
+      /*!
+       * Returns whether or not a file whose data following an ID3v2 tag, if
+       * there is one, starts with \a data can be opened as a TrueAudio file.
+       * This does the same check as isSupported(IOStream *) on data which
+       * has already been read.
+       */
+      static bool isSupported(const ByteVector &data);
+
     private:
-      void read(bool readProperties);
+      void read(bool readProperties, Properties::ReadStyle propertiesStyle);
 
       class FilePrivate;
       std::unique_ptr<FilePrivate> d;
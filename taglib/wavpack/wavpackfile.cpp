@@ -62,31 +62,35 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 bool WavPack::File::isSupported(IOStream *stream)
+{
+  return isSupported(Utils::readHeader(stream, 4, false));
+}
+
+bool WavPack::File::isSupported(const ByteVector &data)
 {
   // A WavPack file has to start with "wvpk".
 
-  const ByteVector id = Utils::readHeader(stream, 4, false);
-  return (id == "wvpk");
+  return (data.startsWith("wvpk"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
-WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle propertiesStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, propertiesStyle);
 }
 
 WavPack::File::~File() = default;
@@ -227,7 +231,7 @@ bool WavPack::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void WavPack::File::read(bool readProperties)
+void WavPack::File::read(bool readProperties, Properties::ReadStyle propertiesStyle)
 {
   // Look for an ID3v1 tag
 
@@ -251,7 +255,7 @@ void WavPack::File::read(bool readProperties)
 
   // Look for WavPack audio properties
 
-  if(readProperties) {
+  if(readProperties && propertiesStyle != Properties::HeadOnly) {
 
     offset_t streamLength;
 
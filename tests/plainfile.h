@@ -38,6 +38,8 @@ public:
   AudioProperties *audioProperties() const override { return nullptr; }
   bool save() override { return false; }
   void truncate(long length) { File::truncate(length); }
+  void beginEdit() { File::beginEdit(); }
+  void commitEdit() { File::commitEdit(); }
 
   ByteVector readAll() {
     seek(0, End);
@@ -43,6 +43,7 @@ class TestASF : public CppUnit::TestFixture
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testLosslessProperties);
   CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testReadHeaderAtOnce);
   CPPUNIT_TEST(testSaveMultipleValues);
   CPPUNIT_TEST(testSaveStream);
   CPPUNIT_TEST(testSaveLanguage);
@@ -53,6 +54,8 @@ class TestASF : public CppUnit::TestFixture
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testPropertiesAllSupported);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testSaveIntoPadding);
+  CPPUNIT_TEST(testIsSupported);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -95,6 +98,14 @@ public:
     CPPUNIT_ASSERT_EQUAL(String("test"), f.tag()->title());
   }
 
+  void testReadHeaderAtOnce()
+  {
+    ASF::File f(TEST_FILE_PATH_C("silence-1.wma"));
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(String("test"), f.tag()->title());
+    CPPUNIT_ASSERT_EQUAL(3ULL, f.ioStatistics().readCalls);
+  }
+
   void testSaveMultipleValues()
   {
     ScopedFileCopy copy("silence-1", ".wma");
@@ -391,13 +402,56 @@ public:
       ASF::File f(copy.fileName().c_str());
       f.tag()->setTitle(longText(128 * 1024));
       f.save();
-      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(297578), f.length());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(297746), f.length());
       f.tag()->setTitle(longText(16 * 1024));
       f.save();
-      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(68202), f.length());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(68370), f.length());
     }
   }
 
+  void testSaveIntoPadding()
+  {
+    ScopedFileCopy copy("silence-1", ".wma");
+
+    offset_t length;
+    {
+      ASF::File f(copy.fileName().c_str());
+      length = f.length();
+      f.tag()->setTitle("a slightly longer title");
+      f.tag()->setArtist("artist");
+      f.resetIOStatistics();
+      CPPUNIT_ASSERT(f.save());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+      CPPUNIT_ASSERT(f.ioStatistics().bytesWritten < 8192);
+    }
+    {
+      ASF::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("a slightly longer title"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("artist"), f.tag()->artist());
+      f.tag()->setTitle("");
+      CPPUNIT_ASSERT(f.save());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      ASF::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String(), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("artist"), f.tag()->artist());
+      CPPUNIT_ASSERT_EQUAL(3712, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
+  void testIsSupported()
+  {
+    ASF::File f(TEST_FILE_PATH_C("silence-1.wma"));
+    f.seek(0);
+    const ByteVector head = f.readBlock(1024);
+    CPPUNIT_ASSERT(ASF::File::isSupported(head));
+    CPPUNIT_ASSERT(!ASF::File::isSupported(head.mid(0, 15)));
+    CPPUNIT_ASSERT(!ASF::File::isSupported(ByteVector("RIFF")));
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestASF);
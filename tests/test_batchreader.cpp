@@ -0,0 +1,138 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it  under the terms of the GNU Lesser General Public License version  *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "batchreader.h"
+#include "fileref.h"
+#include "tfile.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestBatchReader : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestBatchReader);
+  CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testEmptyList);
+  CPPUNIT_TEST(testCallbackThrows);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testRead()
+  {
+    const vector<string> paths {
+      testFilePath("has-tags.m4a"), testFilePath("empty.ogg"),
+      testFilePath("lame_vbr.mp3"), testFilePath("no-such-file.mp3"),
+      testFilePath("silence-44-s.flac"), testFilePath("rare_frames.mp3"),
+      testFilePath("lossless.wma"), testFilePath("click.wv"),
+      testFilePath("empty.aiff"), testFilePath("no-extension")
+    };
+
+    List<FileName> fileNames;
+    for(const auto &path : paths)
+      fileNames.append(path.c_str());
+
+    BatchReader reader(4);
+    CPPUNIT_ASSERT_EQUAL(4U, reader.threadCount());
+
+    // Only collect the results in the callback, it is called from the worker
+    // threads.
+
+    vector<BatchReader::Result> results(paths.size());
+    vector<int> calls(paths.size(), 0);
+    reader.read(fileNames, [&](FileName, const BatchReader::Result &result) {
+      if(result.index < paths.size()) {
+        results[result.index] = result;
+        calls[result.index]++;
+      }
+    });
+
+    for(size_t i = 0; i < paths.size(); ++i) {
+      CPPUNIT_ASSERT_EQUAL(1, calls[i]);
+
+      const FileRef ref(paths[i].c_str());
+      CPPUNIT_ASSERT_EQUAL(!ref.isNull(), results[i].isValid);
+      if(ref.isNull())
+        continue;
+
+      CPPUNIT_ASSERT(ref.file()->properties() == results[i].properties);
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->lengthInMilliseconds(),
+                           results[i].lengthInMilliseconds);
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->sampleRate(), results[i].sampleRate);
+      CPPUNIT_ASSERT_EQUAL(ref.audioProperties()->channels(), results[i].channels);
+    }
+
+    CPPUNIT_ASSERT(!results[3].isValid);
+    CPPUNIT_ASSERT_EQUAL(String("Test Artist"), results[0].properties["ARTIST"].front());
+  }
+
+  void testEmptyList()
+  {
+    BatchReader reader;
+    CPPUNIT_ASSERT(reader.threadCount() >= 1);
+
+    int calls = 0;
+    reader.read(List<FileName>(), [&](FileName, const BatchReader::Result &) {
+      calls++;
+    });
+    CPPUNIT_ASSERT_EQUAL(0, calls);
+  }
+
+  void testCallbackThrows()
+  {
+    const string path = testFilePath("has-tags.m4a");
+    List<FileName> fileNames;
+    for(int i = 0; i < 20; ++i)
+      fileNames.append(path.c_str());
+
+    // The exception is passed to the caller after the threads have been
+    // joined, and no more files are read after it was thrown.
+
+    BatchReader reader(4);
+    int calls = 0;
+    bool thrown = false;
+    try {
+      reader.read(fileNames, [&](FileName, const BatchReader::Result &) {
+        if(++calls == 3)
+          throw std::runtime_error("stop");
+      });
+    }
+    catch(const std::runtime_error &e) {
+      thrown = true;
+      CPPUNIT_ASSERT_EQUAL(string("stop"), string(e.what()));
+    }
+    CPPUNIT_ASSERT(thrown);
+    CPPUNIT_ASSERT(calls >= 3);
+    CPPUNIT_ASSERT(calls <= 6);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestBatchReader);
@@ -50,6 +50,7 @@ class TestByteVector : public CppUnit::TestFixture
   CPPUNIT_TEST(testReplaceAndDetach);
   CPPUNIT_TEST(testIterator);
   CPPUNIT_TEST(testResize);
+  CPPUNIT_TEST(testAssign);
   CPPUNIT_TEST(testAppend1);
   CPPUNIT_TEST(testAppend2);
   CPPUNIT_TEST(testBase64);
@@ -400,6 +401,45 @@ public:
     CPPUNIT_ASSERT_EQUAL('3', *it4);
   }
 
+  void testAssign()
+  {
+    // Empty vectors share their buffer, modifying one must not affect others.
+
+    ByteVector a;
+    ByteVector b;
+    a.resize(3, 'x');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("xxx"), a);
+    CPPUNIT_ASSERT(b.isEmpty());
+
+    a.clear();
+    a.append('y');
+    CPPUNIT_ASSERT_EQUAL(ByteVector("y"), a);
+    CPPUNIT_ASSERT(b.isEmpty());
+    CPPUNIT_ASSERT(ByteVector().data() == nullptr);
+
+    ByteVector c("abcdef");
+    ByteVector d;
+    d = c;
+    d[0] = 'X';
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), c);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("Xbcdef"), d);
+
+    d = c.mid(2, 3);
+    d = d;
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cde"), d);
+
+    // The data may point into the vector's own buffer.
+
+    d.setData(d.data() + 1, 2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("de"), d);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abcdef"), c);
+
+    d = 'z';
+    CPPUNIT_ASSERT_EQUAL(ByteVector("z"), d);
+    d = "";
+    CPPUNIT_ASSERT(d.isEmpty());
+  }
+
   void testResize()
   {
     ByteVector a = ByteVector("0123456789");
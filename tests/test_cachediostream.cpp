@@ -0,0 +1,153 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it  under the terms of the GNU Lesser General Public License version  *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tbytevectorstream.h"
+#include "tcachediostream.h"
+#include "tcountingiostream.h"
+#include "tfilestream.h"
+#include "fileref.h"
+#include "tag.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestCachedIOStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestCachedIOStream);
+  CPPUNIT_TEST(testRead);
+  CPPUNIT_TEST(testEviction);
+  CPPUNIT_TEST(testWrite);
+  CPPUNIT_TEST(testFewerReads);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testRead()
+  {
+    ByteVector data("0123456789abcdefghijklmnopqrstuvwxyz");
+    ByteVectorStream stream(data);
+    CountingIOStream counter(&stream);
+    CachedIOStream cache(&counter, 8, 4);
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123"), cache.readBlock(4));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("4567"), cache.readBlock(4));
+    CPPUNIT_ASSERT_EQUAL(1ULL, counter.statistics().readCalls);
+
+    cache.seek(6);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("6789ab"), cache.readBlock(6));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(12), cache.tell());
+    CPPUNIT_ASSERT_EQUAL(2ULL, counter.statistics().readCalls);
+
+    cache.seek(-4, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("wxyz"), cache.readBlock(10));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), cache.readBlock(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(36), cache.length());
+
+    // Large reads bypass the cache.
+
+    cache.seek(2);
+    CPPUNIT_ASSERT_EQUAL(data.mid(2, 20), cache.readBlock(20));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(22), cache.tell());
+  }
+
+  void testEviction()
+  {
+    ByteVector data(64, 'x');
+    for(unsigned int i = 0; i < data.size(); ++i)
+      data[i] = static_cast<char>(i);
+    ByteVectorStream stream(data);
+    CountingIOStream counter(&stream);
+    CachedIOStream cache(&counter, 8, 2);
+
+    cache.seek(0);
+    cache.readBlock(1);
+    cache.seek(8);
+    cache.readBlock(1);
+    cache.seek(0);
+    cache.readBlock(1);
+    CPPUNIT_ASSERT_EQUAL(2ULL, counter.statistics().readCalls);
+
+    // Block 1 is the least recently used one and gets dropped.
+
+    cache.seek(16);
+    cache.readBlock(1);
+    cache.seek(0);
+    CPPUNIT_ASSERT_EQUAL(data.mid(0, 2), cache.readBlock(2));
+    CPPUNIT_ASSERT_EQUAL(3ULL, counter.statistics().readCalls);
+    cache.seek(8);
+    CPPUNIT_ASSERT_EQUAL(data.mid(8, 2), cache.readBlock(2));
+    CPPUNIT_ASSERT_EQUAL(4ULL, counter.statistics().readCalls);
+  }
+
+  void testWrite()
+  {
+    ByteVector data("0123456789");
+    ByteVectorStream stream(data);
+    CachedIOStream cache(&stream, 4, 4);
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("01"), cache.readBlock(2));
+    cache.writeBlock("AB");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), cache.tell());
+    cache.seek(0);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("01AB"), cache.readBlock(4));
+
+    cache.insert("xyz", 10);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(13), cache.length());
+    cache.seek(8);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("89xyz"), cache.readBlock(5));
+
+    cache.removeBlock(0, 2);
+    cache.truncate(6);
+    cache.seek(0);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("AB4567"), cache.readBlock(6));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("AB4567"), *stream.data());
+  }
+
+  void testFewerReads()
+  {
+    const string fileName = TEST_FILE_PATH_C("has-tags.m4a");
+
+    FileStream direct(fileName.c_str());
+    CountingIOStream directCounter(&direct);
+    FileRef directRef(&directCounter);
+    CPPUNIT_ASSERT(!directRef.isNull());
+
+    FileStream stream(fileName.c_str());
+    CountingIOStream counter(&stream);
+    CachedIOStream cache(&counter);
+    FileRef f(&cache);
+    CPPUNIT_ASSERT(!f.isNull());
+
+    CPPUNIT_ASSERT_EQUAL(directRef.tag()->title(), f.tag()->title());
+    CPPUNIT_ASSERT_EQUAL(directRef.tag()->artist(), f.tag()->artist());
+    CPPUNIT_ASSERT_EQUAL(directRef.audioProperties()->lengthInMilliseconds(),
+                         f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT(counter.statistics().readCalls < directCounter.statistics().readCalls);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestCachedIOStream);
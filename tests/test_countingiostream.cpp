@@ -0,0 +1,105 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it  under the terms of the GNU Lesser General Public License version  *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#include "tbytevectorstream.h"
+#include "tcountingiostream.h"
+#include "tfilestream.h"
+#include "fileref.h"
+#include "tag.h"
+#include "mpegfile.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestCountingIOStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestCountingIOStream);
+  CPPUNIT_TEST(testCounters);
+  CPPUNIT_TEST(testFileStatistics);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testCounters()
+  {
+    ByteVector data("abcdefghij");
+    ByteVectorStream stream(data);
+    CountingIOStream counter(&stream);
+
+    CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), counter.readBlock(3));
+    counter.seek(8);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ij"), counter.readBlock(5));
+    counter.insert("XY", 2, 1);
+    counter.removeBlock(0, 1);
+    counter.seek(0, IOStream::End);
+    counter.writeBlock("end");
+    counter.truncate(5);
+
+    const IOStatistics &s = counter.statistics();
+    CPPUNIT_ASSERT_EQUAL(5ULL, s.bytesRead);
+    CPPUNIT_ASSERT_EQUAL(5ULL, s.bytesWritten);
+    CPPUNIT_ASSERT_EQUAL(2ULL, s.readCalls);
+    CPPUNIT_ASSERT_EQUAL(1ULL, s.writeCalls);
+    CPPUNIT_ASSERT_EQUAL(2ULL, s.seekCalls);
+    CPPUNIT_ASSERT_EQUAL(1ULL, s.insertCalls);
+    CPPUNIT_ASSERT_EQUAL(1ULL, s.removeCalls);
+    CPPUNIT_ASSERT_EQUAL(1ULL, s.truncateCalls);
+    CPPUNIT_ASSERT(s.nanoseconds >= 0);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("bXYde"), *stream.data());
+
+    counter.resetStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ULL, counter.statistics().readCalls);
+    CPPUNIT_ASSERT_EQUAL(0ULL, counter.statistics().bytesWritten);
+  }
+
+  void testFileStatistics()
+  {
+    const string fileName = TEST_FILE_PATH_C("xing.mp3");
+    FileStream stream(fileName.c_str());
+    CountingIOStream counter(&stream);
+
+    FileRef f(&counter);
+    CPPUNIT_ASSERT(!f.isNull());
+
+    // The stream also sees the file type detection, the file only its own I/O.
+
+    const IOStatistics fileStatistics = f.file()->ioStatistics();
+    const IOStatistics &streamStatistics = counter.statistics();
+    CPPUNIT_ASSERT(fileStatistics.readCalls > 0);
+    CPPUNIT_ASSERT(fileStatistics.bytesRead > 0);
+    CPPUNIT_ASSERT(fileStatistics.bytesRead <= streamStatistics.bytesRead);
+    CPPUNIT_ASSERT(fileStatistics.readCalls <= streamStatistics.readCalls);
+    CPPUNIT_ASSERT_EQUAL(0ULL, fileStatistics.bytesWritten);
+
+    f.file()->resetIOStatistics();
+    f.tag()->title();
+    CPPUNIT_ASSERT_EQUAL(0ULL, f.file()->ioStatistics().readCalls);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestCountingIOStream);
@@ -23,7 +23,10 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <cstring>
+
 #include "tfile.h"
+#include "tbytevectorstream.h"
 #include "plainfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -35,8 +38,14 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestFile);
   CPPUNIT_TEST(testFindInSmallFile);
   CPPUNIT_TEST(testRFindInSmallFile);
+  CPPUNIT_TEST(testFindInLargeFile);
+  CPPUNIT_TEST(testRFindInLargeFile);
+  CPPUNIT_TEST(testFindBefore);
   CPPUNIT_TEST(testSeek);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testEditTransaction);
+  CPPUNIT_TEST(testTruncateInEdit);
+  CPPUNIT_TEST(testInsertZeros);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -97,6 +106,82 @@ public:
     }
   }
 
+  void testFindInLargeFile()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+    {
+      // Patterns on and across the buffer boundaries, and far beyond the
+      // initial buffer size.
+
+      ByteVector data(3 * 1024 * 1024, 'x');
+      ::memcpy(data.data() + 1022, "abcd", 4);
+      ::memcpy(data.data() + 3071, "abcd", 4);
+      ::memcpy(data.data() + 2000000, "abcd", 4);
+
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1022), file.find("abcd"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(3071), file.find("abcd", 1023));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2000000), file.find("abcd", 3072));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("abcd", 2000001));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("abcde"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), file.tell());
+    }
+  }
+
+  void testRFindInLargeFile()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+    {
+      ByteVector data(3 * 1024 * 1024, 'x');
+      ::memcpy(data.data() + 1022, "abcd", 4);
+      ::memcpy(data.data() + 2000000, "abcd", 4);
+      ::memcpy(data.data() + data.size() - 1025, "abcd", 4);
+
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      const offset_t length = file.length();
+      CPPUNIT_ASSERT_EQUAL(length - 1025, file.rfind("abcd"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2000000), file.rfind("abcd", length - 1026));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2000000), file.rfind("abcd", 2000000));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1022), file.rfind("abcd", 1999999));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.rfind("abcd", 1021));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.rfind("abcde"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), file.tell());
+    }
+  }
+
+  void testFindBefore()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(ByteVector("0123456239", 10));
+      file.truncate(10);
+    }
+    {
+      PlainFile file(name.c_str());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2), file.find("23", 0, "5"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("62", 0, "5"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(7), file.rfind("23", 0, "1"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.rfind("12", 0, "5"));
+    }
+  }
+
   void testSeek()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -139,6 +224,152 @@ public:
     }
   }
 
+  void testEditTransaction()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector original;
+    {
+      PlainFile file(name.c_str());
+      original = file.readAll();
+    }
+    {
+      // Apply the same changes to the file in a transaction and directly
+      // to an in-memory copy.
+
+      ByteVectorStream expected(original);
+      PlainFile file(name.c_str());
+      file.beginEdit();
+
+      file.insert(ByteVector(3000, 'a'), 0, 10);
+      expected.insert(ByteVector(3000, 'a'), 0, 10);
+      file.removeBlock(4000, 200);
+      expected.removeBlock(4000, 200);
+      file.insert(ByteVector("bbbb"), 3500, 4);
+      expected.insert(ByteVector("bbbb"), 3500, 4);
+      file.insert(ByteVector(5000, 'c'), file.length() - 128, 0);
+      expected.insert(ByteVector(5000, 'c'), expected.length() - 128, 0);
+      file.insert(ByteVector("dd"), 2990, 20);
+      expected.insert(ByteVector("dd"), 2990, 20);
+      file.removeBlock(0, 100);
+      expected.removeBlock(0, 100);
+      file.insert(ByteVector("eee"), file.length(), 0);
+      expected.insert(ByteVector("eee"), expected.length(), 0);
+      file.truncate(static_cast<long>(file.length() - 1));
+      expected.truncate(expected.length() - 1);
+
+      CPPUNIT_ASSERT_EQUAL(expected.length(), file.length());
+      CPPUNIT_ASSERT_EQUAL(original, file.readAll());
+
+      file.commitEdit();
+      CPPUNIT_ASSERT_EQUAL(expected.length(), file.length());
+      CPPUNIT_ASSERT_EQUAL(*expected.data(), file.readAll());
+      original = file.readAll();
+    }
+    {
+      // Shrink the file in a transaction.
+
+      PlainFile file(name.c_str());
+      file.beginEdit();
+      file.removeBlock(0, 3000);
+      file.insert(ByteVector("xyz"), 1000, 1000);
+      file.commitEdit();
+
+      ByteVector expected = original.mid(3000);
+      expected = expected.mid(0, 1000) + ByteVector("xyz") + expected.mid(2000);
+      CPPUNIT_ASSERT_EQUAL(expected, file.readAll());
+    }
+  }
+
+  void testInsertZeros()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    PlainFile file(name.c_str());
+    const ByteVector original = file.readAll();
+
+    file.resetIOStatistics();
+    file.insertZeros(2 * 1024 * 1024 + 3, 100, 10);
+
+    // The rest of the file is moved with one write, and the zeros are
+    // written in blocks of at most 1 MiB.
+
+    const IOStatistics statistics = file.ioStatistics();
+    CPPUNIT_ASSERT_EQUAL(0ULL, statistics.insertCalls);
+    CPPUNIT_ASSERT_EQUAL(4ULL, statistics.writeCalls);
+    CPPUNIT_ASSERT_EQUAL(original.size() - 110 + 2ULL * 1024 * 1024 + 3, statistics.bytesWritten);
+
+    const ByteVector expected = original.mid(0, 100) + ByteVector(2 * 1024 * 1024 + 3, '\0') +
+                                original.mid(110);
+    CPPUNIT_ASSERT_EQUAL(expected, file.readAll());
+  }
+
+  void testTruncateInEdit()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    ByteVector original;
+    {
+      PlainFile file(name.c_str());
+      original = file.readAll();
+    }
+    {
+      // Shrink the file after an insertion.
+
+      PlainFile file(name.c_str());
+      file.beginEdit();
+      file.insert(ByteVector("abc"), 100, 0);
+      file.truncate(1000);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1000), file.length());
+      file.commitEdit();
+
+      original = (original.mid(0, 100) + ByteVector("abc") + original.mid(100)).mid(0, 1000);
+      CPPUNIT_ASSERT_EQUAL(original, file.readAll());
+    }
+    {
+      // Extending the file fills it with zeros, truncating to the current
+      // length does nothing.
+
+      PlainFile file(name.c_str());
+      file.beginEdit();
+      file.truncate(1000);
+      file.removeBlock(0, 10);
+      file.truncate(1500);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1500), file.length());
+      file.insert(ByteVector("xy"), 1500, 0);
+      file.commitEdit();
+
+      const ByteVector expected = original.mid(10) + ByteVector(510, '\0') + ByteVector("xy");
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1502), file.length());
+      CPPUNIT_ASSERT_EQUAL(expected, file.readAll());
+    }
+    {
+      // The zeros are only written when the transaction is committed, in
+      // blocks of at most 1 MiB, and can be split like other new data.
+
+      PlainFile file(name.c_str());
+      const ByteVector before = file.readAll();
+      const offset_t length = file.length();
+      file.beginEdit();
+      file.truncate(length + 3 * 1024 * 1024 + 5);
+      file.removeBlock(length + 10, 20);
+      file.insert(ByteVector("z"), length + 100, 0);
+      file.resetIOStatistics();
+      file.commitEdit();
+
+      const IOStatistics statistics = file.ioStatistics();
+      CPPUNIT_ASSERT_EQUAL(6ULL, statistics.writeCalls);
+      CPPUNIT_ASSERT_EQUAL(3ULL * 1024 * 1024 - 14, statistics.bytesWritten);
+
+      const ByteVector expected = before + ByteVector(100, '\0') + ByteVector("z") +
+                                  ByteVector(3 * 1024 * 1024 - 115, '\0');
+      CPPUNIT_ASSERT_EQUAL(expected, file.readAll());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
@@ -25,14 +25,21 @@
 
 #include <string>
 #include <cstdio>
+#include <tuple>
+#include <vector>
 
 #include "tfilestream.h"
+#include "tmmapfilestream.h"
 #include "tbytevectorstream.h"
+#include "tpropertymap.h"
 #include "tag.h"
 #include "fileref.h"
 #include "oggflacfile.h"
 #include "vorbisfile.h"
 #include "mpegfile.h"
+#include "id3v1tag.h"
+#include "id3v2tag.h"
+#include "id3v2header.h"
 #include "mpcfile.h"
 #include "asffile.h"
 #include "speexfile.h"
@@ -46,6 +53,7 @@
 #include "opusfile.h"
 #include "xmfile.h"
 #include "dsffile.h"
+#include "plainfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -76,6 +84,24 @@ namespace
       return new MP4::File(s);
     }
   };
+
+  // Records the end of the furthest read from the stream.
+
+  class ReadRangeStream : public ByteVectorStream
+  {
+  public:
+    using ByteVectorStream::ByteVectorStream;
+
+    ByteVector readBlock(size_t length) override
+    {
+      const offset_t position = tell();
+      ByteVector data = ByteVectorStream::readBlock(length);
+      readEnd = std::max<offset_t>(readEnd, position + data.size());
+      return data;
+    }
+
+    offset_t readEnd { 0 };
+  };
 } // namespace
 
 class TestFileRef : public CppUnit::TestFixture
@@ -102,10 +128,16 @@ class TestFileRef : public CppUnit::TestFixture
   CPPUNIT_TEST(testOpus);
   CPPUNIT_TEST(testDSF);
   CPPUNIT_TEST(testUnsupported);
+  CPPUNIT_TEST(testDetectByContent);
   CPPUNIT_TEST(testCreate);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testDefaultFileExtensions);
   CPPUNIT_TEST(testFileResolver);
+  CPPUNIT_TEST(testHeadOnly);
+  CPPUNIT_TEST(testHeadOnlyReads);
+  CPPUNIT_TEST(testHeadOnlySaveTailTags);
+  CPPUNIT_TEST(testIsSupportedData);
+  CPPUNIT_TEST(testMemoryMapped);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -200,6 +232,19 @@ public:
       fileContent = fs.readBlock(fs.length());
     }
 
+    {
+      MMapFileStream ms(newname.c_str());
+      FileRef f(&ms);
+      CPPUNIT_ASSERT(dynamic_cast<T*>(f.file()));
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT_EQUAL(f.tag()->artist(), String("test artist"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->title(), String("test title"));
+      CPPUNIT_ASSERT_EQUAL(f.tag()->track(), static_cast<unsigned int>(5));
+
+      ms.seek(0);
+      CPPUNIT_ASSERT_EQUAL(fileContent, ms.readBlock(ms.length()));
+    }
+
     {
       ByteVectorStream bs(fileContent);
       FileRef f(&bs);
@@ -347,6 +392,34 @@ public:
     CPPUNIT_ASSERT(f2.isNull());
   }
 
+  void testDetectByContent()
+  {
+    {
+      // An ID3v2 tag precedes the APE header.
+      FileStream fs(TEST_FILE_PATH_C("mac-399-id3v2.ape"), true);
+      ByteVectorStream bs(fs.readBlock(fs.length()));
+      FileRef f(&bs);
+      CPPUNIT_ASSERT(dynamic_cast<APE::File *>(f.file()));
+    }
+    {
+      FileStream fs(TEST_FILE_PATH_C("lame_vbr.mp3"), true);
+      ByteVectorStream bs(fs.readBlock(fs.length()));
+      FileRef f(&bs);
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()));
+    }
+    {
+      // Frame syncs alone are not enough to be detected as MPEG.
+      ByteVectorStream bs(ByteVector(4096, '\xFF') + ByteVector(4096, '\xF0'));
+      FileRef f(&bs);
+      CPPUNIT_ASSERT(f.isNull());
+    }
+    {
+      ByteVectorStream bs((ByteVector()));
+      FileRef f(&bs);
+      CPPUNIT_ASSERT(f.isNull());
+    }
+  }
+
   void testCreate()
   {
     // This is deprecated. But worth it to test.
@@ -419,6 +492,157 @@ public:
       FileRef f(&s);
       CPPUNIT_ASSERT(dynamic_cast<MP4::File *>(f.file()) != nullptr);
     }
+
+    // The resolvers go out of scope, do not leave them registered.
+
+    FileRef::clearFileTypeResolvers();
+
+    {
+      FileRef f(TEST_FILE_PATH_C("xing.mp3"));
+      CPPUNIT_ASSERT(dynamic_cast<MPEG::File *>(f.file()) != nullptr);
+    }
+  }
+
+  void testHeadOnly()
+  {
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      MPEG::File f(copy.fileName().c_str());
+      f.ID3v2Tag(true)->setTitle("ID3v2 Title");
+      f.ID3v1Tag(true)->setTitle("ID3v1 Title");
+      f.ID3v1Tag()->setArtist("ID3v1 Artist");
+      f.save(MPEG::File::AllTags, File::StripOthers, ID3v2::v4, File::DoNotDuplicate);
+    }
+    {
+      // The ID3v1 tag at the end of the file is not read.
+
+      FileRef f(copy.fileName().c_str(), true, AudioProperties::HeadOnly);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT_EQUAL(String("ID3v2 Title"), f.tag()->title());
+      CPPUNIT_ASSERT(f.tag()->artist().isEmpty());
+      CPPUNIT_ASSERT(!f.audioProperties());
+      CPPUNIT_ASSERT(!dynamic_cast<MPEG::File *>(f.file())->hasID3v1Tag());
+      CPPUNIT_ASSERT(!f.save());
+    }
+    {
+      FileRef f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("ID3v1 Artist"), f.tag()->artist());
+      CPPUNIT_ASSERT(f.audioProperties());
+    }
+  }
+
+  void testHeadOnlyReads()
+  {
+    // These files have tags at the beginning, so nothing is read from the
+    // end of the file, where ID3v1 and APE tags would be.
+
+    for(const char *name : { "id3v22-tda.mp3", "silence-44-s.flac", "tagged.tta" }) {
+      ReadRangeStream stream(PlainFile(TEST_FILE_PATH_C(name)).readAll());
+      FileRef f(&stream, true, AudioProperties::HeadOnly);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(!f.audioProperties());
+      CPPUNIT_ASSERT(stream.readEnd <= stream.length() - 128);
+    }
+
+    // These files only have tags at the end, which are read.
+
+    for(const char *name : { "ape-id3v1.mp3", "mac-399-tagged.ape", "tagged.wv", "click.mpc" }) {
+      ReadRangeStream stream(PlainFile(TEST_FILE_PATH_C(name)).readAll());
+      FileRef f(&stream, true, AudioProperties::HeadOnly);
+      CPPUNIT_ASSERT(!f.isNull());
+      CPPUNIT_ASSERT(!f.audioProperties());
+      CPPUNIT_ASSERT(stream.readEnd > stream.length() - 128);
+      CPPUNIT_ASSERT_EQUAL(FileRef(TEST_FILE_PATH_C(name)).tag()->properties(),
+                           f.tag()->properties());
+    }
+
+    // RIFF walks the chunks up to the end of the file in any case.
+
+    ReadRangeStream stream(PlainFile(TEST_FILE_PATH_C("empty.aiff")).readAll());
+    FileRef f(&stream, true, AudioProperties::HeadOnly);
+    CPPUNIT_ASSERT(!f.isNull());
+    CPPUNIT_ASSERT_EQUAL(stream.length(), stream.readEnd);
+  }
+
+  void testHeadOnlySaveTailTags()
+  {
+    ScopedFileCopy copy("tagged", ".wv");
+    {
+      FileRef f(copy.fileName().c_str(), true, AudioProperties::HeadOnly);
+      CPPUNIT_ASSERT_EQUAL(String("TestTitle"), f.tag()->title());
+      f.tag()->setArtist("Artist");
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      FileRef f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("TestTitle"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("Artist"), f.tag()->artist());
+      CPPUNIT_ASSERT(f.audioProperties());
+    }
+  }
+
+  void testIsSupportedData()
+  {
+    // The overloads taking data give the same results as those taking a
+    // stream.  The data of FLAC, APE and TrueAudio follows the ID3v2 tag.
+
+    using StreamCheck = bool (*)(IOStream *);
+    using DataCheck = bool (*)(const ByteVector &);
+    const std::vector<std::tuple<StreamCheck, DataCheck, bool>> checks {
+      { Ogg::Vorbis::File::isSupported, Ogg::Vorbis::File::isSupported, false },
+      { Ogg::FLAC::File::isSupported, Ogg::FLAC::File::isSupported, false },
+      { Ogg::Speex::File::isSupported, Ogg::Speex::File::isSupported, false },
+      { Ogg::Opus::File::isSupported, Ogg::Opus::File::isSupported, false },
+      { FLAC::File::isSupported, FLAC::File::isSupported, true },
+      { MPC::File::isSupported, MPC::File::isSupported, false },
+      { WavPack::File::isSupported, WavPack::File::isSupported, false },
+      { TrueAudio::File::isSupported, TrueAudio::File::isSupported, true },
+      { MP4::File::isSupported, MP4::File::isSupported, false },
+      { ASF::File::isSupported, ASF::File::isSupported, false },
+      { RIFF::AIFF::File::isSupported, RIFF::AIFF::File::isSupported, false },
+      { RIFF::WAV::File::isSupported, RIFF::WAV::File::isSupported, false },
+      { APE::File::isSupported, APE::File::isSupported, true },
+      { DSF::File::isSupported, DSF::File::isSupported, false },
+    };
+
+    for(const char *name : { "empty.ogg", "empty_flac.oga", "empty.spx", "correctness_gain_silent_output.opus",
+                             "silence-44-s.flac", "no-tags.flac", "click.mpc", "click.wv", "empty.tta",
+                             "tagged.tta", "has-tags.m4a", "silence-1.wma", "empty.aiff", "empty.wav",
+                             "mac-399.ape", "empty10ms.dsf", "xing.mp3" }) {
+      const ByteVector data = PlainFile(TEST_FILE_PATH_C(name)).readAll();
+      ByteVector body = data;
+      if(data.startsWith("ID3"))
+        body = data.mid(ID3v2::Header(data.mid(0, ID3v2::Header::size())).completeTagSize());
+
+      bool supported = false;
+      for(const auto &[streamCheck, dataCheck, afterID3v2] : checks) {
+        ByteVectorStream stream(data);
+        const bool result = dataCheck((afterID3v2 ? body : data).mid(0, 1024));
+        CPPUNIT_ASSERT_EQUAL(streamCheck(&stream), result);
+        supported = supported || result;
+      }
+      CPPUNIT_ASSERT_EQUAL(String(name) != "xing.mp3", supported);
+    }
+  }
+
+  void testMemoryMapped()
+  {
+    for(const char *name : { "xing.mp3", "has-tags.m4a", "silence-44-s.flac", "empty.ogg" }) {
+      FileRef buffered(TEST_FILE_PATH_C(name));
+      FileRef mapped(TEST_FILE_PATH_C(name), true, AudioProperties::Average, File::MemoryMapped);
+      CPPUNIT_ASSERT(!mapped.isNull());
+      CPPUNIT_ASSERT(mapped.file()->readOnly());
+      CPPUNIT_ASSERT_EQUAL(buffered.file()->length(), mapped.file()->length());
+      CPPUNIT_ASSERT(buffered.tag()->properties() == mapped.tag()->properties());
+      CPPUNIT_ASSERT_EQUAL(buffered.audioProperties()->lengthInMilliseconds(),
+                           mapped.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(buffered.audioProperties()->bitrate(),
+                           mapped.audioProperties()->bitrate());
+      CPPUNIT_ASSERT(!mapped.save());
+    }
+
+    FileRef missing("/nonexistent/file.mp3", true, AudioProperties::Average, File::MemoryMapped);
+    CPPUNIT_ASSERT(missing.isNull());
   }
 
 };
@@ -0,0 +1,129 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it  under the terms of the GNU Lesser General Public License version  *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#include "tfilestream.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestFileStream);
+  CPPUNIT_TEST(testReadWrite);
+  CPPUNIT_TEST(testInsertRemove);
+#ifndef _WIN32
+  CPPUNIT_TEST(testFileDescriptor);
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadWrite()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    FileStream stream(copy.fileName().c_str());
+    CPPUNIT_ASSERT(stream.isOpen());
+    CPPUNIT_ASSERT(!stream.readOnly());
+
+    stream.truncate(0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), stream.length());
+    stream.seek(0);
+    stream.writeBlock("0123456789");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(10), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(10), stream.length());
+
+    stream.seek(2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("234"), stream.readBlock(3));
+    stream.seek(2, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("78"), stream.readBlock(2));
+    stream.seek(-1, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("9"), stream.readBlock(100));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(), stream.readBlock(1));
+
+    stream.seek(-100, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(10), stream.tell());
+
+    stream.seek(0, IOStream::End);
+    stream.writeBlock("ab");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(12), stream.length());
+    stream.truncate(4);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), stream.length());
+    stream.seek(0);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("0123"), stream.readBlock(10));
+  }
+
+  void testInsertRemove()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    FileStream stream(copy.fileName().c_str());
+    stream.truncate(0);
+
+    ByteVector data;
+    for(int i = 0; i < 5000; ++i)
+      data.append(static_cast<char>(i % 251));
+    stream.writeBlock(data);
+
+    const ByteVector inserted(3000, 'x');
+    stream.insert(inserted, 100, 10);
+    ByteVector expected = data.mid(0, 100) + inserted + data.mid(110);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(expected.size()), stream.length());
+    stream.seek(0);
+    CPPUNIT_ASSERT(stream.readBlock(expected.size()) == expected);
+
+    stream.removeBlock(50, 2000);
+    expected = expected.mid(0, 50) + expected.mid(2050);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(expected.size()), stream.length());
+    stream.seek(0);
+    CPPUNIT_ASSERT(stream.readBlock(expected.size()) == expected);
+  }
+
+#ifndef _WIN32
+
+  void testFileDescriptor()
+  {
+    const string fileName = TEST_FILE_PATH_C("empty.ogg");
+
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    CPPUNIT_ASSERT(fd >= 0);
+    ::lseek(fd, 1, SEEK_SET);
+
+    FileStream stream(fd, false);
+    CPPUNIT_ASSERT(stream.isOpen());
+    CPPUNIT_ASSERT(stream.readOnly());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("ggS"), stream.readBlock(3));
+  }
+
+#endif
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestFileStream);
@@ -68,6 +68,7 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
   CPPUNIT_TEST(testPictureStoredAfterComment);
+  CPPUNIT_TEST(testPictureNotAccessed);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -668,6 +669,36 @@ public:
     CPPUNIT_ASSERT(fileData.startsWith(expectedData));
   }
 
+  void testPictureNotAccessed()
+  {
+    ScopedFileCopy copy("silence-44-s", ".flac");
+    {
+      // The picture is only read when it is accessed, it must be kept when
+      // the file is saved without that.
+
+      FLAC::File f(copy.fileName().c_str());
+      f.xiphComment()->setTitle("New Title");
+      f.save();
+    }
+    {
+      FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("New Title"), f.tag()->title());
+      const List<FLAC::Picture *> pictures = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      CPPUNIT_ASSERT_EQUAL(String("A pixel."), pictures[0]->description());
+      CPPUNIT_ASSERT_EQUAL(150U, pictures[0]->data().size());
+    }
+    {
+      FLAC::File f(copy.fileName().c_str());
+      f.removePictures();
+      f.save();
+    }
+    {
+      FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.pictureList().isEmpty());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
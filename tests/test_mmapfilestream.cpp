@@ -0,0 +1,108 @@
+/***************************************************************************
+    copyright           : (C) 2026 by the TagLib developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it  under the terms of the GNU Lesser General Public License version  *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tmmapfilestream.h"
+#include "tfilestream.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestMMapFileStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestMMapFileStream);
+  CPPUNIT_TEST(testReadBlock);
+  CPPUNIT_TEST(testSeek);
+  CPPUNIT_TEST(testReadOnly);
+  CPPUNIT_TEST(testMissingFile);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testReadBlock()
+  {
+    FileStream fs(TEST_FILE_PATH_C("empty.ogg"), true);
+    MMapFileStream ms(TEST_FILE_PATH_C("empty.ogg"));
+    CPPUNIT_ASSERT(ms.isOpen());
+    CPPUNIT_ASSERT_EQUAL(fs.length(), ms.length());
+
+    fs.seek(100);
+    ms.seek(100);
+    CPPUNIT_ASSERT_EQUAL(fs.readBlock(1000), ms.readBlock(1000));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1100), ms.tell());
+
+    ms.seek(-10, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(10), ms.readBlock(100).size());
+    CPPUNIT_ASSERT(ms.readBlock(100).isEmpty());
+  }
+
+  void testSeek()
+  {
+    MMapFileStream ms(TEST_FILE_PATH_C("empty.ogg"));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), ms.tell());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4328), ms.length());
+
+    ms.seek(100, IOStream::Beginning);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(100), ms.tell());
+    ms.seek(100, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(200), ms.tell());
+    ms.seek(-300, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(200), ms.tell());
+    ms.seek(-100, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4228), ms.tell());
+    ms.seek(300, IOStream::Current);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4528), ms.tell());
+    CPPUNIT_ASSERT(ms.readBlock(10).isEmpty());
+  }
+
+  void testReadOnly()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    const string name = copy.fileName();
+
+    MMapFileStream ms(name.c_str());
+    CPPUNIT_ASSERT(ms.readOnly());
+
+    ms.writeBlock(ByteVector("foo"));
+    ms.insert(ByteVector("bar"), 10);
+    ms.removeBlock(0, 100);
+    ms.truncate(10);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4328), ms.length());
+
+    FileStream fs(name.c_str(), true);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4328), fs.length());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("OggS"), fs.readBlock(4));
+  }
+
+  void testMissingFile()
+  {
+    MMapFileStream ms("/nonexistent/file.ogg");
+    CPPUNIT_ASSERT(!ms.isOpen());
+    CPPUNIT_ASSERT(ms.readBlock(10).isEmpty());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestMMapFileStream);
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <cstdio>
+#include <map>
 
 #include "tbytevectorlist.h"
 #include "tbytevectorstream.h"
@@ -40,6 +41,100 @@
 using namespace std;
 using namespace TagLib;
 
+namespace
+{
+  // An in-memory stream which only stores the blocks that have been written
+  // and reads zeros elsewhere, so that files larger than 4 GiB can be
+  // simulated without using the disk.
+
+  class SparseStream : public IOStream
+  {
+  public:
+    FileName name() const override { return ""; }
+    bool readOnly() const override { return false; }
+    bool isOpen() const override { return true; }
+    offset_t tell() const override { return position; }
+    offset_t length() override { return size; }
+
+    void seek(offset_t offset, Position p = Beginning) override
+    {
+      if(p == Current)
+        offset += position;
+      else if(p == End)
+        offset += size;
+      if(offset >= 0)
+        position = offset;
+    }
+
+    ByteVector readBlock(size_t length) override
+    {
+      if(position >= size)
+        return ByteVector();
+
+      ByteVector data(static_cast<unsigned int>(min<offset_t>(length, size - position)), '\0');
+      for(const auto &[start, block] : blocks) {
+        const offset_t begin = max(start, position);
+        const offset_t end = min(start + block.size(), position + data.size());
+        if(begin < end)
+          copy(block.begin() + (begin - start), block.begin() + (end - start),
+               data.begin() + (begin - position));
+      }
+      position += data.size();
+      return data;
+    }
+
+    void writeBlock(const ByteVector &data) override
+    {
+      splice(position, data.size(), data.size());
+      blocks[position] = data;
+      position += data.size();
+      size = max(size, position);
+    }
+
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override
+    {
+      splice(start, replace, data.size());
+      blocks[start] = data;
+      size += static_cast<offset_t>(data.size()) - static_cast<offset_t>(replace);
+    }
+
+    void removeBlock(offset_t start = 0, size_t length = 0) override
+    {
+      splice(start, length, 0);
+      size -= length;
+    }
+
+    void truncate(offset_t length) override
+    {
+      splice(length, size - length, 0);
+      size = length;
+    }
+
+  private:
+    // Drops the stored data in the range of length bytes at start, and moves
+    // the data after it to start + newLength.
+
+    void splice(offset_t start, offset_t length, offset_t newLength)
+    {
+      map<offset_t, ByteVector> result;
+      for(const auto &[offset, block] : blocks) {
+        const offset_t end = offset + block.size();
+        if(offset < start)
+          result[offset] = block.mid(0, static_cast<unsigned int>(min(end, start) - offset));
+        if(end > start + length) {
+          const offset_t from = max(offset, start + length);
+          result[from - length + newLength] = block.mid(static_cast<unsigned int>(from - offset));
+        }
+      }
+      blocks.swap(result);
+    }
+
+    map<offset_t, ByteVector> blocks;
+    offset_t size { 0 };
+    offset_t position { 0 };
+  };
+}  // namespace
+
 class TestMP4 : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestMP4);
@@ -53,6 +148,13 @@ class TestMP4 : public CppUnit::TestFixture
   CPPUNIT_TEST(testHasTag);
   CPPUNIT_TEST(testIsEmpty);
   CPPUNIT_TEST(testUpdateStco);
+  CPPUNIT_TEST(testUpdateFragments);
+  CPPUNIT_TEST(testSaveStrategy);
+  CPPUNIT_TEST(testPaddingSize);
+  CPPUNIT_TEST(testRelocateMoov);
+  CPPUNIT_TEST(testRelocateLargeMoov);
+  CPPUNIT_TEST(testSaveParentOverflow);
+  CPPUNIT_TEST(testConvertStcoToCo64);
   CPPUNIT_TEST(testSaveExisingWhenIlstIsLast);
   CPPUNIT_TEST(test64BitAtom);
   CPPUNIT_TEST(testGnre);
@@ -200,6 +302,314 @@ public:
     CPPUNIT_ASSERT(!t2.isEmpty());
   }
 
+  void testUpdateFragments()
+  {
+    ScopedFileCopy copy("no-tags", ".3g2");
+    string filename = copy.fileName();
+
+    offset_t length;
+    long long baseDataOffset;
+
+    {
+      MP4::File f(filename.c_str());
+      length = f.length();
+
+      MP4::Atoms a(&f);
+      CPPUNIT_ASSERT(!a.find("moof", "traf"));
+      a.readFragments(&f);
+      MP4::Atom *tfhd = a.find("moof", "traf", "tfhd");
+      CPPUNIT_ASSERT(tfhd);
+      f.seek(tfhd->offset + 16);
+      baseDataOffset = f.readBlock(8).toLongLong();
+      CPPUNIT_ASSERT_EQUAL(62991LL, baseDataOffset);
+
+      f.tag()->setArtist(ByteVector(3000, 'x'));
+      f.save();
+    }
+
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String(ByteVector(3000, 'x')), f.tag()->artist());
+
+      MP4::Atoms a(&f);
+      CPPUNIT_ASSERT(!a.find("moof", "traf"));
+      a.readFragments(&f);
+      MP4::Atom *tfhd = a.find("moof", "traf", "tfhd");
+      CPPUNIT_ASSERT(tfhd);
+      f.seek(tfhd->offset + 16);
+      CPPUNIT_ASSERT_EQUAL(baseDataOffset + f.length() - length, f.readBlock(8).toLongLong());
+    }
+  }
+
+  void testSaveStrategy()
+  {
+    ScopedFileCopy copy("has-tags", ".m4a");
+
+    MP4::File f(copy.fileName().c_str());
+    CPPUNIT_ASSERT_EQUAL(MP4::Tag::NotSaved, f.tag()->saveStrategy());
+    const offset_t length = f.length();
+
+    f.tag()->setTitle("short");
+    f.save();
+    CPPUNIT_ASSERT_EQUAL(MP4::Tag::InPlace, f.tag()->saveStrategy());
+    CPPUNIT_ASSERT_EQUAL(length, f.length());
+
+    f.tag()->setArtist(ByteVector(3000, 'x'));
+    f.save();
+    CPPUNIT_ASSERT_EQUAL(MP4::Tag::ShiftData, f.tag()->saveStrategy());
+    CPPUNIT_ASSERT(f.length() > length);
+  }
+
+  void testPaddingSize()
+  {
+    ScopedFileCopy copy("no-tags", ".m4a");
+    string filename = copy.fileName();
+
+    offset_t length;
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT_EQUAL(0U, f.tag()->paddingSize());
+      f.tag()->setPaddingSize(8192);
+      f.tag()->setTitle("title");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(MP4::Tag::ShiftData, f.tag()->saveStrategy());
+      length = f.length();
+      CPPUNIT_ASSERT(length > 2898 + 8192);
+    }
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("title"), f.tag()->title());
+      f.tag()->setArtist(ByteVector(4000, 'x'));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(MP4::Tag::InPlace, f.tag()->saveStrategy());
+      CPPUNIT_ASSERT_EQUAL(length, f.length());
+    }
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("title"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String(ByteVector(4000, 'x')), f.tag()->artist());
+    }
+  }
+
+  void testRelocateMoov()
+  {
+    ScopedFileCopy copy("moov-first", ".m4a");
+    string filename = copy.fileName();
+
+    const auto readChunks = [](MP4::File &f) {
+      MP4::Atoms a(&f);
+      MP4::Atom *stco = a.find("moov")->findall("stco", true)[0];
+      f.seek(stco->offset + 12);
+      const ByteVector data = f.readBlock(stco->length - 12);
+      ByteVectorList chunks;
+      for(unsigned int i = 0; i < data.toUInt(); ++i) {
+        f.seek(data.toUInt(4 + i * 4));
+        chunks.append(f.readBlock(20));
+      }
+      return chunks;
+    };
+
+    ByteVectorList chunks;
+    offset_t length;
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT(!f.tag()->isMoovRelocationEnabled());
+      chunks = readChunks(f);
+      length = f.length();
+
+      f.tag()->setMoovRelocationEnabled(true);
+      f.tag()->setArtist(ByteVector(3000, 'x'));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(MP4::Tag::RelocateMoov, f.tag()->saveStrategy());
+
+      // The tree is updated, so that saving again works.
+
+      f.tag()->setTitle("title");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(MP4::Tag::InPlace, f.tag()->saveStrategy());
+    }
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String(ByteVector(3000, 'x')), f.tag()->artist());
+      CPPUNIT_ASSERT_EQUAL(String("title"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(3708, f.audioProperties()->lengthInMilliseconds());
+
+      MP4::Atoms a(&f);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("free"), a.atoms[1]->name);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1288), a.atoms[1]->length);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("moov"), a.atoms.back()->name);
+      CPPUNIT_ASSERT_EQUAL(length, a.atoms.back()->offset);
+      CPPUNIT_ASSERT(chunks == readChunks(f));
+
+      // 'moov' is already at the end of the file now.
+
+      f.tag()->setMoovRelocationEnabled(true);
+      f.tag()->setComment(ByteVector(3000, 'y'));
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(MP4::Tag::ShiftData, f.tag()->saveStrategy());
+    }
+    {
+      MP4::File f(filename.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String(ByteVector(3000, 'y')), f.tag()->comment());
+      CPPUNIT_ASSERT(chunks == readChunks(f));
+    }
+  }
+
+  void testConvertStcoToCo64()
+  {
+    // Turns moov-first.m4a into a file of more than 4 GiB, with the media
+    // data just below 4 GiB and a 64-bit 'mdat' header.
+
+    const ByteVector source = PlainFile(TEST_FILE_PATH_C("moov-first.m4a")).readAll();
+    const ByteVector chunkData = source.mid(1320, 1457);
+    const offset_t dataOffset = 0x100000000LL - 1536;
+
+    ByteVector header = source.mid(0, 1312);
+    for(unsigned int i = 0; i < 4; ++i) {
+      const unsigned int pos = 1256 + i * 4;
+      const ByteVector entry = ByteVector::fromUInt(
+        static_cast<unsigned int>(header.toUInt(pos) - 1320 + dataOffset));
+      copy(entry.begin(), entry.end(), header.begin() + pos);
+    }
+    header.append(ByteVector::fromUInt(1));
+    header.append("mdat");
+    header.append(ByteVector::fromLongLong(dataOffset + chunkData.size() - 1312));
+
+    SparseStream stream;
+    stream.writeBlock(header);
+    stream.seek(dataOffset);
+    stream.writeBlock(chunkData);
+    stream.writeBlock(source.mid(2777));
+
+    const auto readChunks = [](MP4::File &f, const char *name) {
+      MP4::Atoms a(&f);
+      const MP4::AtomList tables = a.find("moov")->findall(name, true);
+      CPPUNIT_ASSERT_EQUAL(1U, tables.size());
+      const unsigned int entrySize = name == string("co64") ? 8 : 4;
+      f.seek(tables.front()->offset + 12);
+      const ByteVector data = f.readBlock(tables.front()->length - 12);
+      ByteVectorList chunks;
+      for(unsigned int i = 0; i < data.toUInt(); ++i) {
+        const unsigned int pos = 4 + i * entrySize;
+        f.seek(entrySize == 8 ? data.toLongLong(pos) : data.toUInt(pos));
+        chunks.append(f.readBlock(20));
+      }
+      return chunks;
+    };
+
+    ByteVectorList chunks;
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(3708, f.audioProperties()->lengthInMilliseconds());
+      chunks = readChunks(f, "stco");
+      CPPUNIT_ASSERT(chunks[0] != ByteVector(20, '\0'));
+
+      f.tag()->setArtist(ByteVector(3000, 'x'));
+      f.save();
+    }
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT(stream.length() > 0x100000000LL);
+      CPPUNIT_ASSERT_EQUAL(String(ByteVector(3000, 'x')), f.tag()->artist());
+      CPPUNIT_ASSERT_EQUAL(3708, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT(chunks == readChunks(f, "co64"));
+
+      // Saving again only shifts the 64-bit entries.
+
+      f.tag()->setArtist(ByteVector(6000, 'x'));
+      f.save();
+    }
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String(ByteVector(6000, 'x')), f.tag()->artist());
+      CPPUNIT_ASSERT(chunks == readChunks(f, "co64"));
+    }
+  }
+
+  void testRelocateLargeMoov()
+  {
+    // A 'moov' of more than 4 GiB, followed by even more media data, is not
+    // relocated but saved by shifting the data.
+
+    const ByteVector source = PlainFile(TEST_FILE_PATH_C("moov-first.m4a")).readAll();
+    const offset_t freeLength = 0x100000000LL;
+    const offset_t moovLength = 16 + 1280 + freeLength;
+    const offset_t mdatLength = 0x140000000LL;
+
+    ByteVector header = source.mid(0, 24);
+    header.append(ByteVector::fromUInt(1));
+    header.append("moov");
+    header.append(ByteVector::fromLongLong(moovLength));
+    header.append(source.mid(32, 1280));
+    header.append(ByteVector::fromUInt(1));
+    header.append("free");
+    header.append(ByteVector::fromLongLong(freeLength));
+
+    SparseStream stream;
+    stream.writeBlock(header);
+    stream.seek(24 + moovLength);
+    stream.writeBlock(ByteVector::fromUInt(1) + ByteVector("mdat") +
+                      ByteVector::fromLongLong(mdatLength));
+    stream.seek(24 + moovLength + mdatLength - 1);
+    stream.writeBlock(ByteVector(1, '\0'));
+
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      f.tag()->setMoovRelocationEnabled(true);
+      f.tag()->setTitle("title");
+      f.save();
+      CPPUNIT_ASSERT_EQUAL(MP4::Tag::ShiftData, f.tag()->saveStrategy());
+    }
+    {
+      MP4::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("title"), f.tag()->title());
+
+      MP4::Atoms a(&f);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("moov"), a.atoms[1]->name);
+      CPPUNIT_ASSERT(a.atoms[1]->length > moovLength);
+      CPPUNIT_ASSERT_EQUAL(stream.length(), a.atoms[2]->offset + a.atoms[2]->length);
+    }
+  }
+
+  void testSaveParentOverflow()
+  {
+    // A 'moov' with a 32-bit size which can not grow any more is not
+    // modified.
+
+    const ByteVector source = PlainFile(TEST_FILE_PATH_C("moov-first.m4a")).readAll();
+    const offset_t moovLength = 0xFFFFFF00LL;
+    const offset_t freeLength = moovLength - 8 - 1280;
+
+    ByteVector header = source.mid(0, 24);
+    header.append(ByteVector::fromUInt(static_cast<unsigned int>(moovLength)));
+    header.append("moov");
+    header.append(source.mid(32, 1280));
+    header.append(ByteVector::fromUInt(1));
+    header.append("free");
+    header.append(ByteVector::fromLongLong(freeLength));
+
+    SparseStream stream;
+    stream.writeBlock(header);
+    stream.seek(24 + moovLength);
+    stream.writeBlock(ByteVector::fromUInt(16) + ByteVector("mdat") + ByteVector(8, '\0'));
+
+    MP4::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    f.tag()->setTitle(String(ByteVector(4096, 'x')));
+    CPPUNIT_ASSERT(!f.save());
+    CPPUNIT_ASSERT_EQUAL(MP4::Tag::NotSaved, f.tag()->saveStrategy());
+    CPPUNIT_ASSERT_EQUAL(24 + moovLength + 16, stream.length());
+  }
+
   void testUpdateStco()
   {
     ScopedFileCopy copy("no-tags", ".3g2");
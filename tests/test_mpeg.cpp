@@ -33,8 +33,10 @@
 #include "id3v1tag.h"
 #include "apetag.h"
 #include "mpegproperties.h"
+#include "tbytevectorstream.h"
 #include "xingheader.h"
 #include "mpegheader.h"
+#include "id3v2framefactory.h"
 #include "id3v2extendedheader.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -49,6 +51,7 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testAudioPropertiesXingHeaderVBR);
   CPPUNIT_TEST(testAudioPropertiesVBRIHeader);
   CPPUNIT_TEST(testAudioPropertiesNoVBRHeaders);
+  CPPUNIT_TEST(testAudioPropertiesAccurateVBR);
   CPPUNIT_TEST(testSkipInvalidFrames1);
   CPPUNIT_TEST(testSkipInvalidFrames2);
   CPPUNIT_TEST(testSkipInvalidFrames3);
@@ -58,6 +61,7 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDuplicateID3v2);
   CPPUNIT_TEST(testFuzzedFile);
   CPPUNIT_TEST(testFrameOffset);
+  CPPUNIT_TEST(testHeaderFromBuffer);
   CPPUNIT_TEST(testStripAndProperties);
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testRepeatedSave1);
@@ -126,6 +130,66 @@ public:
     CPPUNIT_ASSERT_EQUAL(209, lastHeader.frameLength());
   }
 
+  void testAudioPropertiesAccurateVBR()
+  {
+    // 100 frames of 128 kbps followed by 100 frames of 320 kbps, MPEG-1
+    // Layer III, 44100 Hz, mono, without a VBR header.
+
+    ByteVector data;
+    for(int i = 0; i < 200; ++i) {
+      const bool high = i >= 100;
+      ByteVector frame(high ? 1044 : 417, '\0');
+      frame[0] = '\xFF';
+      frame[1] = '\xFB';
+      frame[2] = high ? '\xE0' : '\x90';
+      frame[3] = '\xC0';
+      data.append(frame);
+    }
+
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Average);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT(!f.audioProperties()->xingHeader());
+      CPPUNIT_ASSERT_EQUAL(128, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(9131, f.audioProperties()->lengthInMilliseconds());
+    }
+    {
+      ByteVectorStream stream(data);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Accurate);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(224, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(5224, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+      CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->channels());
+    }
+    {
+      // 100 padded frames of 128 kbps.
+
+      ByteVector padded;
+      for(int i = 0; i < 100; ++i) {
+        ByteVector frame(418, '\0');
+        frame[0] = '\xFF';
+        frame[1] = '\xFB';
+        frame[2] = '\x92';
+        frame[3] = '\xC0';
+        padded.append(frame);
+      }
+
+      ByteVectorStream stream(padded);
+      MPEG::File f(&stream, ID3v2::FrameFactory::instance(), true, MPEG::Properties::Accurate);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(128, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(2612, f.audioProperties()->lengthInMilliseconds());
+    }
+    {
+      MPEG::File f(TEST_FILE_PATH_C("bladeenc.mp3"), true, MPEG::Properties::Accurate);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
+    }
+  }
+
   void testSkipInvalidFrames1()
   {
     MPEG::File f(TEST_FILE_PATH_C("invalid-frames1.mp3"));
@@ -255,6 +319,26 @@ public:
     }
   }
 
+  void testHeaderFromBuffer()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("ape-id3v2.mp3"));
+    const offset_t offset = f.firstFrameOffset();
+
+    const MPEG::Header fileHeader(&f, offset, false);
+    f.seek(offset);
+    const MPEG::Header bufferHeader(f.readBlock(4));
+    CPPUNIT_ASSERT(fileHeader.isValid());
+    CPPUNIT_ASSERT(bufferHeader.isValid());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.version(), bufferHeader.version());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.layer(), bufferHeader.layer());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.bitrate(), bufferHeader.bitrate());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.sampleRate(), bufferHeader.sampleRate());
+    CPPUNIT_ASSERT_EQUAL(fileHeader.frameLength(), bufferHeader.frameLength());
+
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("\xFF\xFB", 2)).isValid());
+    CPPUNIT_ASSERT(!MPEG::Header(ByteVector("\xFF\xFF\x90\x00", 4)).isValid());
+  }
+
   void testStripAndProperties()
   {
     ScopedFileCopy copy("xing", ".mp3");
@@ -32,6 +32,7 @@
 #include "tpropertymap.h"
 #include "oggfile.h"
 #include "vorbisfile.h"
+#include "oggpage.h"
 #include "oggpageheader.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -49,6 +50,7 @@ class TestOGG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDictInterface2);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testPageChecksum);
+  CPPUNIT_TEST(testRenumberPages);
   CPPUNIT_TEST(testPageGranulePosition);
   CPPUNIT_TEST_SUITE_END();
 
@@ -224,6 +226,41 @@ public:
 
   }
 
+  void testRenumberPages()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    string newname = copy.fileName();
+
+    {
+      Vorbis::File f(newname.c_str());
+      f.tag()->setTitle(longText(128 * 1024, true));
+      f.save();
+    }
+    {
+      Vorbis::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+
+      // The pages following the comment have been renumbered in place, check
+      // that their sequence numbers and checksums match freshly rendered ones.
+
+      offset_t offset = 0;
+      int sequenceNumber = 0;
+      while(offset < f.length()) {
+        Ogg::Page page(&f, offset);
+        CPPUNIT_ASSERT(page.header()->isValid());
+        CPPUNIT_ASSERT_EQUAL(sequenceNumber, page.pageSequenceNumber());
+
+        const ByteVector rendered = page.render();
+        f.seek(offset);
+        CPPUNIT_ASSERT_EQUAL(rendered, f.readBlock(page.size()));
+
+        offset += page.size();
+        sequenceNumber++;
+      }
+      CPPUNIT_ASSERT_EQUAL(20, sequenceNumber);
+    }
+  }
+
   void testPageGranulePosition()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -23,6 +23,11 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
 #include "tpropertymap.h"
 #include "tag.h"
 #include "apetag.h"
@@ -31,6 +36,7 @@
 #include "id3v2tag.h"
 #include "infotag.h"
 #include "mp4tag.h"
+#include "mp4file.h"
 #include "xiphcomment.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -49,6 +55,8 @@ class TestPropertyMap : public CppUnit::TestFixture
   CPPUNIT_TEST(testGetSetMp4);
   CPPUNIT_TEST(testGetSetXiphComment);
   CPPUNIT_TEST(testGetSet);
+  CPPUNIT_TEST(testInternedKeys);
+  CPPUNIT_TEST(testConcurrentInternedKeys);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -198,6 +206,62 @@ public:
     CPPUNIT_ASSERT(!props.isEmpty());
   }
 
+  void testInternedKeys()
+  {
+    PropertyMap props1;
+    PropertyMap props2;
+    props1.insert("title", StringList("Title 1"));
+    props2.replace(String("Title"), StringList("Title 2"));
+    props1.insert(String("my") + "key", StringList("Value 1"));
+    props2.insert(String("MY") + "KEY", StringList("Value 2"));
+
+    // Well-known keys share their data, others are kept as they are.
+
+    const String &title1 = props1.find("TITLE")->first;
+    const String &title2 = props2.find("TITLE")->first;
+    CPPUNIT_ASSERT_EQUAL(String("TITLE"), title1);
+    CPPUNIT_ASSERT_EQUAL(title1, title2);
+    CPPUNIT_ASSERT(title1.toCString() == title2.toCString());
+
+    const String &key1 = props1.find("MYKEY")->first;
+    const String &key2 = props2.find("MYKEY")->first;
+    CPPUNIT_ASSERT_EQUAL(key1, key2);
+    CPPUNIT_ASSERT(key1.toCString() != key2.toCString());
+
+    CPPUNIT_ASSERT_EQUAL(StringList("Title 1"), props1["Title"]);
+    CPPUNIT_ASSERT_EQUAL(StringList("Value 2"), props2.value("mykey"));
+  }
+
+  void testConcurrentInternedKeys()
+  {
+    // The well-known keys are shared by all files, so converting them with
+    // toCString() must be safe while other threads do the same.  The MP4
+    // item keys include non-ASCII ones such as "\251nam".
+
+    std::atomic<int> mismatches { 0 };
+    std::atomic<int> keys { 0 };
+    const auto read = [&] {
+      for(int i = 0; i < 50; ++i) {
+        MP4::File f(TEST_FILE_PATH_C("has-tags.m4a"));
+        for(const auto &[key, item] : f.tag()->itemMap()) {
+          if(::strcmp(key.toCString(true), key.to8Bit(true).c_str()) != 0 ||
+             ::strcmp(key.toCString(false), key.to8Bit(false).c_str()) != 0)
+            ++mismatches;
+          ++keys;
+        }
+      }
+    };
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; ++i)
+      threads.emplace_back(read);
+    for(auto &thread : threads)
+      thread.join();
+
+    CPPUNIT_ASSERT(keys > 0);
+    CPPUNIT_ASSERT_EQUAL(0, mismatches.load());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestPropertyMap);
@@ -53,6 +53,8 @@ class TestString : public CppUnit::TestFixture
   CPPUNIT_TEST(testEncodeNonBMP);
   CPPUNIT_TEST(testIterator);
   CPPUNIT_TEST(testInvalidUTF8);
+  CPPUNIT_TEST(testCompactStorage);
+  CPPUNIT_TEST(testUTF8AsciiPrefix);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -366,6 +368,65 @@ public:
     CPPUNIT_ASSERT(String(ByteVector("\xED\xB0\x80\xED\xA0\x80"), String::UTF8).isEmpty());
   }
 
+  void testCompactStorage()
+  {
+    // Latin-1 strings are stored compactly, the results must not depend on
+    // how a string has been created.
+
+    const String latin1("caf\xe9", String::Latin1);
+    const String utf8("caf\xc3\xa9", String::UTF8);
+    const String wide(L"caf\u00e9");
+    CPPUNIT_ASSERT(latin1 == utf8);
+    CPPUNIT_ASSERT(latin1 == wide);
+    CPPUNIT_ASSERT(latin1 == L"caf\u00e9");
+    CPPUNIT_ASSERT_EQUAL(std::string("caf\xc3\xa9"), latin1.to8Bit(true));
+    CPPUNIT_ASSERT_EQUAL(std::string("caf\xe9"), wide.to8Bit(false));
+    CPPUNIT_ASSERT_EQUAL(std::string("caf\xc3\xa9"), std::string(wide.toCString(true)));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("\0c\0a\0f\0\xe9", 8), latin1.data(String::UTF16BE));
+    CPPUNIT_ASSERT(wcscmp(L"caf\u00e9", latin1.toCWString()) == 0);
+    CPPUNIT_ASSERT_EQUAL(L'\u00e9', latin1[3]);
+
+    String s("abc");
+    const String t = s;
+    s += L'\u2160';
+    CPPUNIT_ASSERT_EQUAL(4U, s.size());
+    CPPUNIT_ASSERT(!s.isLatin1());
+    CPPUNIT_ASSERT(s.startsWith(t));
+    CPPUNIT_ASSERT_EQUAL(String("abc"), t);
+    CPPUNIT_ASSERT(t < s);
+    CPPUNIT_ASSERT_EQUAL(3, s.find(String(L"\u2160")));
+    CPPUNIT_ASSERT_EQUAL(String(L"ABC\u2160"), s.upper());
+
+    String u = t;
+    u[0] = L'x';
+    u += "yz";
+    CPPUNIT_ASSERT_EQUAL(String("xbcyz"), u);
+    CPPUNIT_ASSERT_EQUAL(String("abc"), t);
+    CPPUNIT_ASSERT(String("a") < String("\xff", String::Latin1));
+  }
+
+  void testUTF8AsciiPrefix()
+  {
+    // Non-ASCII characters at any position around the 8 byte blocks which are
+    // checked at once.
+
+    for(unsigned int i = 0; i < 20; ++i) {
+      std::string utf8(20, 'a');
+      utf8.replace(i, 1, "\xe2\x85\xa0");
+      std::wstring wide(20, L'a');
+      wide[i] = L'\u2160';
+
+      const String s(utf8, String::UTF8);
+      CPPUNIT_ASSERT(s == wide.c_str());
+      CPPUNIT_ASSERT_EQUAL(utf8, s.to8Bit(true));
+      CPPUNIT_ASSERT_EQUAL(ByteVector(utf8.data(), static_cast<unsigned int>(utf8.size())),
+                           String(wide).data(String::UTF8));
+
+      utf8.resize(i + 2);
+      CPPUNIT_ASSERT(String(utf8, String::UTF8).isEmpty());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestString);
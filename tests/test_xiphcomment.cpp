@@ -49,6 +49,8 @@ class TestXiphComment : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveFields);
   CPPUNIT_TEST(testPicture);
   CPPUNIT_TEST(testLowercaseFields);
+  CPPUNIT_TEST(testPictureNotAccessed);
+  CPPUNIT_TEST(testInvalidPictureNotAccessed);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -211,6 +213,65 @@ public:
     }
   }
 
+  void testPictureNotAccessed()
+  {
+    Ogg::XiphComment comment;
+    auto picture = new FLAC::Picture();
+    picture->setType(FLAC::Picture::FrontCover);
+    picture->setMimeType("image/png");
+    picture->setData("PNG data");
+    comment.addPicture(picture);
+    comment.setTitle("Title");
+    const ByteVector data = comment.render();
+
+    // Pictures are decoded on demand but must survive rendering and removal.
+
+    CPPUNIT_ASSERT_EQUAL(data, Ogg::XiphComment(data).render());
+
+    // fieldCount() counts the pictures without decoding them.
+
+    Ogg::XiphComment counted(data);
+    CPPUNIT_ASSERT_EQUAL(2U, counted.fieldCount());
+    CPPUNIT_ASSERT_EQUAL(1U, counted.pictureList().size());
+    CPPUNIT_ASSERT_EQUAL(2U, counted.fieldCount());
+
+    Ogg::XiphComment removed(data);
+    removed.removeAllPictures();
+    CPPUNIT_ASSERT(removed.pictureList().isEmpty());
+
+    Ogg::XiphComment added(data);
+    added.addPicture(new FLAC::Picture());
+    const List<FLAC::Picture *> pictures = added.pictureList();
+    CPPUNIT_ASSERT_EQUAL(2U, pictures.size());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("PNG data"), pictures.front()->data());
+  }
+
+  void testInvalidPictureNotAccessed()
+  {
+    ByteVector data = ByteVector::fromUInt(6, false) + ByteVector("vendor");
+    data.append(ByteVector::fromUInt(2, false));
+    data.append(ByteVector::fromUInt(11, false) + ByteVector("TITLE=Title"));
+    data.append(ByteVector::fromUInt(27, false) + ByteVector("METADATA_BLOCK_PICTURE=****"));
+
+    // The invalid picture is written back as it was, so the number of
+    // fields still matches the fields present.
+
+    const ByteVector rendered = Ogg::XiphComment(data).render(false);
+    CPPUNIT_ASSERT_EQUAL(data, rendered);
+
+    Ogg::XiphComment comment(rendered);
+    CPPUNIT_ASSERT_EQUAL(2U, comment.fieldCount());
+    CPPUNIT_ASSERT_EQUAL(String("Title"), comment.title());
+
+    // Accessing the pictures drops it.
+
+    CPPUNIT_ASSERT(comment.pictureList().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(1U, comment.fieldCount());
+    const Ogg::XiphComment parsed(comment.render(false));
+    CPPUNIT_ASSERT_EQUAL(1U, parsed.fieldCount());
+    CPPUNIT_ASSERT_EQUAL(String("Title"), parsed.title());
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestXiphComment);